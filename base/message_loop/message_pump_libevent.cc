@@ -17,6 +17,10 @@
 #include "base/time/time.h"
 #include "third_party/libevent/event.h"
 
+#if defined(OS_LINUX)
+#include <sys/eventfd.h>
+#endif
+
 #if defined(OS_MACOSX)
 #include "base/mac/scoped_nsautorelease_pool.h"
 #endif
@@ -114,7 +118,8 @@ MessagePumpLibevent::MessagePumpLibevent()
       processed_io_events_(false),
       event_base_(event_base_new()),
       wakeup_pipe_in_(-1),
-      wakeup_pipe_out_(-1) {
+      wakeup_pipe_out_(-1),
+      wakeup_pending_(0) {
   if (!Init())
      NOTREACHED();
 }
@@ -128,7 +133,7 @@ MessagePumpLibevent::~MessagePumpLibevent() {
     if (IGNORE_EINTR(close(wakeup_pipe_in_)) < 0)
       DPLOG(ERROR) << "close";
   }
-  if (wakeup_pipe_out_ >= 0) {
+  if (wakeup_pipe_out_ >= 0 && wakeup_pipe_out_ != wakeup_pipe_in_) {
     if (IGNORE_EINTR(close(wakeup_pipe_out_)) < 0)
       DPLOG(ERROR) << "close";
   }
@@ -285,10 +290,22 @@ void MessagePumpLibevent::Quit() {
 }
 
 void MessagePumpLibevent::ScheduleWork() {
+  // If a wakeup is already pending, Run() is guaranteed to call DoWork()
+  // after OnWakeup() clears |wakeup_pending_|, so there is no need to write
+  // again. The barrier orders the caller's task queue update before the read
+  // of |wakeup_pending_|; OnWakeup() has the matching one.
+  subtle::MemoryBarrier();
+  if (subtle::NoBarrier_CompareAndSwap(&wakeup_pending_, 0, 1) != 0)
+    return;
+
   // Tell libevent (in a threadsafe way) that it should break out of its loop.
+#if defined(OS_LINUX)
+  uint64 buf = 1;
+#else
   char buf = 0;
-  int nwrite = HANDLE_EINTR(write(wakeup_pipe_in_, &buf, 1));
-  DCHECK(nwrite == 1 || errno == EAGAIN)
+#endif
+  int nwrite = HANDLE_EINTR(write(wakeup_pipe_in_, &buf, sizeof(buf)));
+  DCHECK(nwrite == static_cast<int>(sizeof(buf)) || errno == EAGAIN)
       << "[nwrite:" << nwrite << "] [errno:" << errno << "]";
 }
 
@@ -309,6 +326,17 @@ void MessagePumpLibevent::DidProcessIOEvent() {
 }
 
 bool MessagePumpLibevent::Init() {
+#if defined(OS_LINUX)
+  // An eventfd needs a single descriptor, and repeated writes collapse into
+  // one counter.
+  int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (fd < 0) {
+    DLOG(ERROR) << "eventfd() failed, errno: " << errno;
+    return false;
+  }
+  wakeup_pipe_out_ = fd;
+  wakeup_pipe_in_ = fd;
+#else
   int fds[2];
   if (pipe(fds)) {
     DLOG(ERROR) << "pipe() failed, errno: " << errno;
@@ -324,6 +352,7 @@ bool MessagePumpLibevent::Init() {
   }
   wakeup_pipe_out_ = fds[0];
   wakeup_pipe_in_ = fds[1];
+#endif
 
   wakeup_event_ = new event;
   event_set(wakeup_event_, wakeup_pipe_out_, EV_READ | EV_PERSIST,
@@ -361,10 +390,19 @@ void MessagePumpLibevent::OnWakeup(int socket, short flags, void* context) {
   MessagePumpLibevent* that = static_cast<MessagePumpLibevent*>(context);
   DCHECK(that->wakeup_pipe_out_ == socket);
 
-  // Remove and discard the wakeup byte.
+  // Remove and discard the wakeup byte, or the eventfd counter.
+#if defined(OS_LINUX)
+  uint64 buf;
+#else
   char buf;
-  int nread = HANDLE_EINTR(read(socket, &buf, 1));
-  DCHECK_EQ(nread, 1);
+#endif
+  int nread = HANDLE_EINTR(read(socket, &buf, sizeof(buf)));
+  DCHECK_EQ(nread, static_cast<int>(sizeof(buf)));
+
+  // Any ScheduleWork() from now on must write again. The barrier orders this
+  // store before DoWork() reads the task queue.
+  subtle::NoBarrier_Store(&that->wakeup_pending_, 0);
+  subtle::MemoryBarrier();
   that->processed_io_events_ = true;
   // Tell libevent to break out of inner loop.
   event_base_loopbreak(that->event_base_);
@@ -5,6 +5,7 @@
 #ifndef BASE_MESSAGE_LOOP_MESSAGE_PUMP_LIBEVENT_H_
 #define BASE_MESSAGE_LOOP_MESSAGE_PUMP_LIBEVENT_H_
 
+#include "base/atomicops.h"
 #include "base/basictypes.h"
 #include "base/compiler_specific.h"
 #include "base/memory/weak_ptr.h"
@@ -140,7 +141,7 @@ class BASE_EXPORT MessagePumpLibevent : public MessagePump {
   static void OnLibeventNotification(int fd, short flags,
                                      void* context);
 
-  // Unix pipe used to implement ScheduleWork()
+  // Unix pipe (an eventfd on Linux) used to implement ScheduleWork()
   // ... callback; called by libevent inside Run() when pipe is ready to read
   static void OnWakeup(int socket, short flags, void* context);
 
@@ -162,10 +163,14 @@ class BASE_EXPORT MessagePumpLibevent : public MessagePump {
 
   // ... write end; ScheduleWork() writes a single byte to it
   int wakeup_pipe_in_;
-  // ... read end; OnWakeup reads it and then breaks Run() out of its sleep
+  // ... read end; OnWakeup reads it and then breaks Run() out of its sleep.
+  // Same as |wakeup_pipe_in_| when an eventfd is used.
   int wakeup_pipe_out_;
   // ... libevent wrapper for read end
   event* wakeup_event_;
+  // ... non-zero while a wakeup has been written but not yet read. Further
+  // ScheduleWork() calls made in that window skip the write() syscall.
+  subtle::Atomic32 wakeup_pending_;
 
   ObserverList<IOObserver> io_observers_;
   ThreadChecker watch_file_descriptor_caller_checker_;
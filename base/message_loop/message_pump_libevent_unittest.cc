@@ -4,6 +4,7 @@
 
 #include "base/message_loop/message_pump_libevent.h"
 
+#include <errno.h>
 #include <unistd.h>
 
 #include "base/bind.h"
@@ -49,6 +50,10 @@ class MessagePumpLibeventTest : public testing::Test {
     pump->OnLibeventNotification(0, EV_WRITE | EV_READ, controller);
   }
 
+  int wakeup_fd(MessagePumpLibevent* pump) const {
+    return pump->wakeup_pipe_out_;
+  }
+
   int pipefds_[2];
 
  private:
@@ -194,6 +199,18 @@ TEST_F(MessagePumpLibeventTest, NestedPumpWatcher) {
   OnLibeventNotification(pump.get(), &watcher);
 }
 
+TEST_F(MessagePumpLibeventTest, CoalescedScheduleWork) {
+  scoped_ptr<MessagePumpLibevent> pump(new MessagePumpLibevent);
+  for (int i = 0; i < 10; ++i)
+    pump->ScheduleWork();
+
+  // Only the first call wrote a wakeup, so it drains with a single read.
+  char buf[8];
+  EXPECT_LT(0, HANDLE_EINTR(read(wakeup_fd(pump.get()), buf, sizeof(buf))));
+  EXPECT_EQ(-1, HANDLE_EINTR(read(wakeup_fd(pump.get()), buf, sizeof(buf))));
+  EXPECT_EQ(EAGAIN, errno);
+}
+
 }  // namespace
 
 }  // namespace base
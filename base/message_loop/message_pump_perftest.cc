@@ -2,13 +2,18 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include "base/atomicops.h"
 #include "base/bind.h"
 #include "base/format_macros.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/memory/scoped_vector.h"
+#include "base/message_loop/message_loop.h"
+#include "base/run_loop.h"
 #include "base/strings/stringprintf.h"
 #include "base/synchronization/condition_variable.h"
 #include "base/synchronization/lock.h"
 #include "base/synchronization/waitable_event.h"
+#include "base/threading/platform_thread.h"
 #include "base/threading/thread.h"
 #include "base/time/time.h"
 #include "build/build_config.h"
@@ -19,6 +24,13 @@
 #include "base/android/java_handler_thread.h"
 #endif
 
+#if defined(OS_POSIX) && !defined(OS_NACL)
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "base/posix/eintr_wrapper.h"
+#endif
+
 namespace base {
 namespace {
 
@@ -289,5 +301,198 @@ TEST_F(PostTaskTest, OneHundredTasksPerReload) {
   Run(1000, 100);
 }
 
+#if defined(OS_POSIX) && !defined(OS_NACL)
+// One end of a loopback socketpair. Every byte read is echoed back, until
+// the initiating end has completed |round_trips| exchanges.
+class PingPongSocket : public MessageLoopForIO::Watcher {
+ public:
+  PingPongSocket(int fd, int round_trips, const Closure& done_callback)
+      : fd_(fd),
+        round_trips_left_(round_trips),
+        done_callback_(done_callback) {}
+
+  ~PingPongSocket() override {
+    watcher_.StopWatchingFileDescriptor();
+    if (IGNORE_EINTR(close(fd_)) < 0)
+      PLOG(ERROR) << "close";
+  }
+
+  void Start(bool send_first) {
+    MessageLoopForIO::current()->WatchFileDescriptor(
+        fd_, true, MessageLoopForIO::WATCH_READ, &watcher_, this);
+    if (send_first)
+      Send();
+  }
+
+  // MessageLoopForIO::Watcher implementation:
+  void OnFileCanReadWithoutBlocking(int fd) override {
+    char byte;
+    if (HANDLE_EINTR(read(fd_, &byte, 1)) != 1)
+      return;
+    if (!done_callback_.is_null() && --round_trips_left_ == 0) {
+      done_callback_.Run();
+      return;
+    }
+    Send();
+  }
+  void OnFileCanWriteWithoutBlocking(int fd) override { NOTREACHED(); }
+
+ private:
+  void Send() {
+    char byte = 0;
+    PCHECK(HANDLE_EINTR(write(fd_, &byte, 1)) == 1);
+  }
+
+  int fd_;
+  int round_trips_left_;
+  Closure done_callback_;
+  MessageLoopForIO::FileDescriptorWatcher watcher_;
+
+  DISALLOW_COPY_AND_ASSIGN(PingPongSocket);
+};
+
+// Counts the readiness notifications dispatched by the pump.
+class IOEventCounter : public MessageLoopForIO::IOObserver {
+ public:
+  IOEventCounter() : count_(0) {}
+
+  void WillProcessIOEvent() override { count_++; }
+  void DidProcessIOEvent() override {}
+
+  int count() const { return count_; }
+
+ private:
+  int count_;
+};
+
+class SocketPingPongTest : public testing::Test {
+ public:
+  SocketPingPongTest()
+      : pairs_left_(0), stop_posting_(0), cross_thread_tasks_run_(0) {}
+
+  // Runs |round_trips| one byte exchanges over each of |num_pairs|
+  // socketpairs at once, and reports the throughput along with the number of
+  // pump notifications needed per exchange. Meanwhile, each of
+  // |num_posting_threads| threads keeps one task at a time posted to the
+  // loop, so that the busy IO pump is also woken through ScheduleWork() from
+  // other threads.
+  void Run(int num_pairs, int round_trips, int num_posting_threads) {
+    MessageLoopForIO loop;
+    IOEventCounter counter;
+    loop.AddIOObserver(&counter);
+
+    RunLoop run_loop;
+    quit_closure_ = run_loop.QuitClosure();
+    pairs_left_ = num_pairs;
+    subtle::NoBarrier_Store(&stop_posting_, 0);
+    cross_thread_tasks_run_ = 0;
+
+    ScopedVector<Thread> posting_threads;
+    tasks_in_flight_.reset(new subtle::Atomic32[num_posting_threads]);
+    for (int i = 0; i < num_posting_threads; ++i) {
+      subtle::NoBarrier_Store(&tasks_in_flight_[i], 0);
+      posting_threads.push_back(new Thread("posting thread"));
+      posting_threads[i]->Start();
+      posting_threads[i]->message_loop()->PostTask(
+          FROM_HERE, Bind(&SocketPingPongTest::PostTasks, Unretained(this),
+                          &loop, &tasks_in_flight_[i]));
+    }
+
+    ScopedVector<PingPongSocket> sockets;
+    for (int i = 0; i < num_pairs; ++i) {
+      int fds[2];
+      ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+      sockets.push_back(new PingPongSocket(
+          fds[0], round_trips,
+          Bind(&SocketPingPongTest::OnPairDone, Unretained(this))));
+      sockets.push_back(new PingPongSocket(fds[1], 0, Closure()));
+    }
+
+    TimeTicks start = TimeTicks::HighResNow();
+    for (size_t i = 0; i < sockets.size(); ++i)
+      sockets[i]->Start(i % 2 == 0);
+    run_loop.Run();
+    TimeDelta elapsed = TimeTicks::HighResNow() - start;
+    loop.RemoveIOObserver(&counter);
+
+    // The posting threads stop once they see |stop_posting_|. Their last
+    // tasks are still queued, so run those before |tasks_in_flight_| goes.
+    posting_threads.clear();
+    RunLoop().RunUntilIdle();
+
+    int total_round_trips = num_pairs * round_trips;
+    std::string trace = StringPrintf("%d_socketpairs_%d_posting_threads",
+                                     num_pairs, num_posting_threads);
+    perf_test::PrintResult("socket_ping_pong", "", trace,
+                           total_round_trips / elapsed.InSecondsF(),
+                           "round_trips/s", true);
+    perf_test::PrintResult(
+        "socket_ping_pong", "_io_events", trace,
+        counter.count() / static_cast<double>(total_round_trips),
+        "events/round_trip", false);
+    if (num_posting_threads) {
+      perf_test::PrintResult(
+          "socket_ping_pong", "_cross_thread_tasks", trace,
+          cross_thread_tasks_run_ / elapsed.InSecondsF(), "tasks/s", true);
+    }
+  }
+
+ private:
+  void OnPairDone() {
+    if (--pairs_left_ == 0) {
+      subtle::Release_Store(&stop_posting_, 1);
+      quit_closure_.Run();
+    }
+  }
+
+  // Runs on a posting thread. Posts a task to |target| each time the
+  // previous one has run, until the exchanges finish. Each post finds the
+  // loop's queue empty, so it goes through the pump's ScheduleWork().
+  void PostTasks(MessageLoop* target, subtle::Atomic32* in_flight) {
+    while (!subtle::Acquire_Load(&stop_posting_)) {
+      if (subtle::Acquire_Load(in_flight)) {
+        PlatformThread::YieldCurrentThread();
+        continue;
+      }
+      subtle::NoBarrier_Store(in_flight, 1);
+      target->PostTask(FROM_HERE,
+                       Bind(&SocketPingPongTest::CrossThreadTask,
+                            Unretained(this), in_flight));
+    }
+  }
+
+  void CrossThreadTask(subtle::Atomic32* in_flight) {
+    cross_thread_tasks_run_++;
+    subtle::Release_Store(in_flight, 0);
+  }
+
+  Closure quit_closure_;
+  int pairs_left_;
+
+  // Set on the IO thread when the exchanges are done.
+  subtle::Atomic32 stop_posting_;
+  // One flag per posting thread, set while its task is queued.
+  scoped_ptr<subtle::Atomic32[]> tasks_in_flight_;
+  int cross_thread_tasks_run_;
+};
+
+TEST_F(SocketPingPongTest, OneSocketPair) {
+  Run(1, 100000, 0);
+}
+
+TEST_F(SocketPingPongTest, OneHundredSocketPairs) {
+  Run(100, 1000, 0);
+}
+
+// These exercise the cross-thread wakeups that the pump coalesces.
+TEST_F(SocketPingPongTest, OneSocketPairFourPostingThreads) {
+  Run(1, 100000, 4);
+}
+
+TEST_F(SocketPingPongTest, OneHundredSocketPairsFourPostingThreads) {
+  Run(100, 1000, 4);
+}
+#endif  // defined(OS_POSIX) && !defined(OS_NACL)
+
 }  // namespace
 }  // namespace base
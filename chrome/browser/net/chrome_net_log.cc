@@ -10,6 +10,7 @@
 #include "base/logging.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
+#include "base/threading/thread.h"
 #include "base/values.h"
 #include "chrome/browser/net/net_log_temp_file.h"
 #include "chrome/browser/ui/webui/net_internals/net_internals_ui.h"
@@ -27,11 +28,9 @@ ChromeNetLog::ChromeNetLog()
     base::FilePath log_path =
         command_line->GetSwitchValuePath(switches::kLogNetLog);
     // Much like logging.h, bypass threading restrictions by using fopen
-    // directly.  Have to write on a thread that's shutdown to handle events on
-    // shutdown properly, and posting events to another thread as they occur
-    // would result in an unbounded buffer size, so not much can be gained by
-    // doing this on another thread.  It's only used when debugging Chrome, so
-    // performance is not a big concern.
+    // directly.  Events are written on a thread owned by this NetLog, rather
+    // than a BrowserThread, so that events logged during shutdown are still
+    // written, while the network thread doesn't block on disk writes.
     FILE* file = NULL;
 #if defined(OS_WIN)
     file = _wfopen(log_path.value().c_str(), L"w");
@@ -44,7 +43,10 @@ ChromeNetLog::ChromeNetLog()
                  << " for net logging";
     } else {
       scoped_ptr<base::Value> constants(NetInternalsUI::GetConstants());
-      net_log_logger_.reset(new net::NetLogLogger(file, *constants));
+      net_log_file_thread_.reset(new base::Thread("NetLogFileThread"));
+      net_log_file_thread_->Start();
+      net_log_logger_.reset(new net::NetLogLogger(
+          file, *constants, net_log_file_thread_->message_loop_proxy()));
       if (command_line->HasSwitch(switches::kNetLogLevel)) {
         std::string log_level_string =
             command_line->GetSwitchValueASCII(switches::kNetLogLevel);
@@ -11,6 +11,10 @@
 #include "base/synchronization/lock.h"
 #include "net/base/net_log.h"
 
+namespace base {
+class Thread;
+}
+
 namespace net {
 class NetLogLogger;
 class TraceNetLogObserver;
@@ -30,6 +34,9 @@ class ChromeNetLog : public net::NetLog {
   }
 
  private:
+  // Writes |net_log_logger_|'s file. Declared first so that it is stopped,
+  // after the logger's final writes, only once everything else is gone.
+  scoped_ptr<base::Thread> net_log_file_thread_;
   scoped_ptr<net::NetLogLogger> net_log_logger_;
   scoped_ptr<NetLogTempFile> net_log_temp_file_;
 
@@ -118,8 +118,14 @@ void NetLogTempFile::StartNetLog(bool strip_private_data) {
   if (file == NULL)
     return;
 
+  // Events are written on this thread rather than on the threads logging
+  // them. StopNetLog() runs here too, so the file is complete by the time it
+  // returns.
   scoped_ptr<base::Value> constants(NetInternalsUI::GetConstants());
-  net_log_logger_.reset(new net::NetLogLogger(file, *constants));
+  net_log_logger_.reset(new net::NetLogLogger(
+      file, *constants,
+      BrowserThread::GetMessageLoopProxyForThread(
+          BrowserThread::FILE_USER_BLOCKING)));
   if (strip_private_data) {
     net_log_logger_->set_log_level(net::NetLog::LOG_STRIP_PRIVATE_DATA);
     log_type_ = LOG_TYPE_STRIP_PRIVATE_DATA;
@@ -21,6 +21,7 @@
 #include "base/run_loop.h"
 #include "base/stl_util.h"
 #include "base/strings/stringprintf.h"
+#include "base/sys_info.h"
 #include "base/task/cancelable_task_tracker.h"
 #include "chrome/browser/browser_process.h"
 #include "chrome/browser/chrome_notification_types.h"
@@ -29,6 +30,7 @@
 #include "chrome/browser/sessions/session_service.h"
 #include "chrome/browser/sessions/session_service_factory.h"
 #include "chrome/browser/sessions/session_service_utils.h"
+#include "chrome/browser/sessions/tab_load_queue.h"
 #include "chrome/browser/sessions/tab_loader_delegate.h"
 #include "chrome/browser/ui/browser.h"
 #include "chrome/browser/ui/browser_finder.h"
@@ -70,6 +72,11 @@ class TabLoader;
 
 TabLoader* shared_tab_loader = NULL;
 
+// Lower bound on the number of tabs TabLoader lets load in parallel before
+// the force load timer stops starting new loads. The bound used is the
+// larger of this and the number of processors.
+const int kMinTabLoadLimit = 2;
+
 // Pointers to SessionRestoreImpls which are currently restoring the session.
 std::set<SessionRestoreImpl*>* active_session_restorers = NULL;
 
@@ -91,7 +98,8 @@ void NotifySessionRestored(SessionRestore::CallbackList* callbacks) {
 // TabLoader is responsible for loading tabs after session restore has finished
 // creating all the tabs. Tabs are loaded after a previously tab finishes
 // loading or a timeout is reached. If the timeout is reached before a tab
-// finishes loading the timeout delay is doubled.
+// finishes loading the timeout delay is doubled. See TabLoadQueue for the
+// order tabs are loaded in, and for when a timeout starts a new load.
 //
 // TabLoader keeps a reference to itself when it's loading. When it has finished
 // loading, it drops the reference. If another profile is restored while the
@@ -132,8 +140,6 @@ class TabLoader : public content::NotificationObserver,
  private:
   friend class base::RefCounted<TabLoader>;
 
-  typedef std::set<NavigationController*> TabsLoading;
-  typedef std::list<NavigationController*> TabsToLoad;
   typedef std::set<RenderWidgetHost*> RenderWidgetHostSet;
 
   explicit TabLoader(base::TimeTicks restore_started);
@@ -159,7 +165,8 @@ class TabLoader : public content::NotificationObserver,
   void RemoveTab(NavigationController* tab);
 
   // Invoked from |force_load_timer_|. Doubles |force_load_delay_multiplier_|
-  // and invokes |LoadNextTab| to load the next tab
+  // and invokes |LoadNextTab| to load the next tab, unless |tab_queue_| holds
+  // off to let the tabs already loading finish.
   void ForceLoadTimerFired();
 
   // Returns the RenderWidgetHost associated with a tab if there is one,
@@ -199,12 +206,9 @@ class TabLoader : public content::NotificationObserver,
   // Have we recorded the times for a foreground tab paint?
   bool got_first_paint_;
 
-  // The set of tabs we've initiated loading on. This does NOT include the
-  // selected tabs.
-  TabsLoading tabs_loading_;
-
-  // The tabs we need to load.
-  TabsToLoad tabs_to_load_;
+  // The tabs we need to load, and the tabs we've initiated loading on. The
+  // latter does NOT include the selected tabs.
+  TabLoadQueue tab_queue_;
 
   // The renderers we have started loading into.
   RenderWidgetHostSet render_widget_hosts_loading_;
@@ -243,18 +247,14 @@ TabLoader* TabLoader::GetTabLoader(base::TimeTicks restore_started) {
 void TabLoader::ScheduleLoad(NavigationController* controller) {
   CheckNotObserving(controller);
   DCHECK(controller);
-  DCHECK(find(tabs_to_load_.begin(), tabs_to_load_.end(), controller) ==
-         tabs_to_load_.end());
-  tabs_to_load_.push_back(controller);
+  tab_queue_.Add(controller);
   RegisterForNotifications(controller);
 }
 
 void TabLoader::TabIsLoading(NavigationController* controller) {
   CheckNotObserving(controller);
   DCHECK(controller);
-  DCHECK(find(tabs_loading_.begin(), tabs_loading_.end(), controller) ==
-         tabs_loading_.end());
-  tabs_loading_.insert(controller);
+  tab_queue_.AddLoading(controller);
   RenderWidgetHost* render_widget_host = GetRenderWidgetHost(controller);
   DCHECK(render_widget_host);
   render_widget_hosts_loading_.insert(render_widget_host);
@@ -301,6 +301,8 @@ TabLoader::TabLoader(base::TimeTicks restore_started)
       loading_enabled_(true),
       got_first_foreground_load_(false),
       got_first_paint_(false),
+      tab_queue_(std::max(kMinTabLoadLimit,
+                          base::SysInfo::NumberOfProcessors())),
       tab_count_(0),
       restore_started_(restore_started),
       max_parallel_tab_loads_(0),
@@ -309,7 +311,7 @@ TabLoader::TabLoader(base::TimeTicks restore_started)
 
 TabLoader::~TabLoader() {
   DCHECK((got_first_paint_ || render_widget_hosts_to_paint_.empty()) &&
-          tabs_loading_.empty() && tabs_to_load_.empty());
+          tab_queue_.loading_count() == 0 && tab_queue_.empty());
   shared_tab_loader = NULL;
 }
 
@@ -317,13 +319,11 @@ void TabLoader::LoadNextTab() {
   // LoadNextTab should only get called after we have started the tab
   // loading.
   CHECK(delegate_);
-  if (!tabs_to_load_.empty()) {
-    NavigationController* tab = tabs_to_load_.front();
-    DCHECK(tab);
-    tabs_loading_.insert(tab);
-    if (tabs_loading_.size() > max_parallel_tab_loads_)
-      max_parallel_tab_loads_ = tabs_loading_.size();
-    tabs_to_load_.pop_front();
+  NavigationController* tab = tab_queue_.Pop();
+  if (tab) {
+    tab_queue_.AddLoading(tab);
+    if (tab_queue_.loading_count() > max_parallel_tab_loads_)
+      max_parallel_tab_loads_ = tab_queue_.loading_count();
     tab->LoadIfNecessary();
     content::WebContents* contents = tab->GetWebContents();
     if (contents) {
@@ -342,12 +342,12 @@ void TabLoader::LoadNextTab() {
     }
   }
 
-  if (!tabs_to_load_.empty())
+  if (!tab_queue_.empty())
     StartTimer();
 
   // When the session restore is done synchronously, notification is sent from
   // SessionRestoreImpl::Restore .
-  if (tabs_to_load_.empty() && !SessionRestore::IsRestoringSynchronously()) {
+  if (tab_queue_.empty() && !SessionRestore::IsRestoringSynchronously()) {
     NotifySessionRestored(on_session_restored_callbacks_);
   }
 }
@@ -464,7 +464,7 @@ void TabLoader::Observe(int type,
   // eventually call StartLoading (which assigns this_retainer_), or drop the
   // reference without initiating a load.
   if ((got_first_paint_ || render_widget_hosts_to_paint_.empty()) &&
-      tabs_loading_.empty() && tabs_to_load_.empty())
+      tab_queue_.loading_count() == 0 && tab_queue_.empty())
     this_retainer_ = NULL;
 }
 
@@ -476,19 +476,15 @@ void TabLoader::RemoveTab(NavigationController* tab) {
   registrar_.Remove(this, content::NOTIFICATION_LOAD_START,
                     content::Source<NavigationController>(tab));
 
-  TabsLoading::iterator i = tabs_loading_.find(tab);
-  if (i != tabs_loading_.end())
-    tabs_loading_.erase(i);
-
-  TabsToLoad::iterator j =
-      find(tabs_to_load_.begin(), tabs_to_load_.end(), tab);
-  if (j != tabs_to_load_.end())
-    tabs_to_load_.erase(j);
+  tab_queue_.Remove(tab);
 }
 
 void TabLoader::ForceLoadTimerFired() {
   force_load_delay_multiplier_ *= 2;
-  LoadNextTab();
+  if (tab_queue_.OnForceLoadTimeout())
+    LoadNextTab();
+  else
+    StartTimer();
 }
 
 RenderWidgetHost* TabLoader::GetRenderWidgetHost(NavigationController* tab) {
@@ -516,7 +512,7 @@ void TabLoader::HandleTabClosedOrLoaded(NavigationController* tab) {
   RemoveTab(tab);
   if (delegate_ && loading_enabled_)
     LoadNextTab();
-  if (tabs_loading_.empty() && tabs_to_load_.empty()) {
+  if (tab_queue_.loading_count() == 0 && tab_queue_.empty()) {
     base::TimeDelta time_to_load =
         base::TimeTicks::Now() - restore_started_;
     UMA_HISTOGRAM_CUSTOM_TIMES(
@@ -543,12 +539,8 @@ void TabLoader::HandleTabClosedOrLoaded(NavigationController* tab) {
 }
 
 void TabLoader::CheckNotObserving(NavigationController* controller) {
-  const bool in_tabs_to_load =
-      find(tabs_to_load_.begin(), tabs_to_load_.end(), controller) !=
-          tabs_to_load_.end();
-  const bool in_tabs_loading =
-      find(tabs_loading_.begin(), tabs_loading_.end(), controller) !=
-          tabs_loading_.end();
+  const bool in_tabs_to_load = tab_queue_.IsQueued(controller);
+  const bool in_tabs_loading = tab_queue_.IsLoading(controller);
   const bool observing =
       registrar_.IsRegistered(
           this, content::NOTIFICATION_WEB_CONTENTS_DESTROYED,
@@ -570,15 +562,12 @@ base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level) {
   // When receiving a resource pressure level warning, we stop pre-loading more
   // tabs since we are running in danger of loading more tabs by throwing out
   // old ones.
-  if (tabs_to_load_.empty())
+  if (tab_queue_.empty())
     return;
   // Stop the timer and suppress any tab loads while we clean the list.
   SetTabLoadingEnabled(false);
-  while (!tabs_to_load_.empty()) {
-    NavigationController* controller = tabs_to_load_.front();
-    tabs_to_load_.pop_front();
+  while (NavigationController* controller = tab_queue_.Pop())
     RemoveTab(controller);
-  }
   // By calling |LoadNextTab| explicitly, we make sure that the
   // |NOTIFICATION_SESSION_RESTORE_DONE| event gets sent.
   LoadNextTab();
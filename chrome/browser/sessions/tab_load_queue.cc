@@ -0,0 +1,87 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/sessions/tab_load_queue.h"
+
+#include <algorithm>
+
+#include "base/logging.h"
+#include "content/public/browser/navigation_controller.h"
+#include "content/public/browser/navigation_entry.h"
+
+using content::NavigationController;
+
+TabLoadQueue::TabLoadQueue(size_t max_loads)
+    : max_loads_(max_loads),
+      stalled_(false) {
+  DCHECK_GT(max_loads_, 0u);
+}
+
+TabLoadQueue::~TabLoadQueue() {
+}
+
+void TabLoadQueue::Add(NavigationController* tab) {
+  DCHECK(tab);
+  DCHECK(!IsQueued(tab));
+  const base::Time last_used = GetLastUsedTime(tab);
+  std::list<NavigationController*>::iterator i = queued_.begin();
+  while (i != queued_.end() && GetLastUsedTime(*i) >= last_used)
+    ++i;
+  queued_.insert(i, tab);
+}
+
+NavigationController* TabLoadQueue::Pop() {
+  if (queued_.empty())
+    return NULL;
+  NavigationController* tab = queued_.front();
+  queued_.pop_front();
+  return tab;
+}
+
+void TabLoadQueue::AddLoading(NavigationController* tab) {
+  DCHECK(tab);
+  DCHECK(!IsLoading(tab));
+  loading_.insert(tab);
+  stalled_ = false;
+}
+
+void TabLoadQueue::Remove(NavigationController* tab) {
+  if (loading_.erase(tab))
+    stalled_ = false;
+  stuck_.erase(tab);
+  std::list<NavigationController*>::iterator i =
+      std::find(queued_.begin(), queued_.end(), tab);
+  if (i != queued_.end())
+    queued_.erase(i);
+}
+
+bool TabLoadQueue::OnForceLoadTimeout() {
+  if (loading_.size() < max_loads_)
+    return true;
+  if (!stalled_) {
+    // Give the loads in flight another timeout to make progress.
+    stalled_ = true;
+    return false;
+  }
+  // None of the loads in flight made progress for two timeouts. Stop waiting
+  // for them, so that a few hung pages can't hold up the rest of the restore.
+  stuck_.insert(loading_.begin(), loading_.end());
+  loading_.clear();
+  stalled_ = false;
+  return true;
+}
+
+// static
+base::Time TabLoadQueue::GetLastUsedTime(NavigationController* tab) {
+  content::NavigationEntry* entry = tab->GetLastCommittedEntry();
+  return entry ? entry->GetTimestamp() : base::Time();
+}
+
+bool TabLoadQueue::IsQueued(NavigationController* tab) const {
+  return std::find(queued_.begin(), queued_.end(), tab) != queued_.end();
+}
+
+bool TabLoadQueue::IsLoading(NavigationController* tab) const {
+  return loading_.count(tab) != 0 || stuck_.count(tab) != 0;
+}
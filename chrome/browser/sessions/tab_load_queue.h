@@ -0,0 +1,83 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_BROWSER_SESSIONS_TAB_LOAD_QUEUE_H_
+#define CHROME_BROWSER_SESSIONS_TAB_LOAD_QUEUE_H_
+
+#include <list>
+#include <set>
+
+#include "base/basictypes.h"
+#include "base/time/time.h"
+
+namespace content {
+class NavigationController;
+}
+
+// Tracks the tabs session restore still has to load in the background and the
+// tabs it is loading. Queued tabs are loaded most recently used first, so the
+// tabs the user is most likely to switch to are ready soonest.
+//
+// The force load timer only starts another load while fewer than |max_loads|
+// tabs are loading, so restoring a large session doesn't flood the network
+// and every renderer at once. Tabs still loading after two timeouts in a row
+// without any load starting or finishing are considered stuck, and stop
+// counting against that limit. Stuck tabs are still loading, though, and are
+// tracked until they finish or are closed like any other.
+class TabLoadQueue {
+ public:
+  explicit TabLoadQueue(size_t max_loads);
+  ~TabLoadQueue();
+
+  // Queues |tab| for loading. Tabs used equally recently keep the order they
+  // were queued in, which is their order in the tab strip.
+  void Add(content::NavigationController* tab);
+
+  // Removes and returns the tab to load next, or NULL if no tab is queued.
+  content::NavigationController* Pop();
+
+  // Records that |tab| has started loading.
+  void AddLoading(content::NavigationController* tab);
+
+  // Forgets |tab|, whether it is queued or loading.
+  void Remove(content::NavigationController* tab);
+
+  // Invoked when the force load timer fires, which happens when no load has
+  // started or finished for a whole timeout. Returns true if the next tab
+  // should be loaded.
+  bool OnForceLoadTimeout();
+
+  // Returns the time the current entry of |tab| was navigated to, which for a
+  // restored tab approximates when the user last used it.
+  static base::Time GetLastUsedTime(content::NavigationController* tab);
+
+  bool IsQueued(content::NavigationController* tab) const;
+  bool IsLoading(content::NavigationController* tab) const;
+
+  bool empty() const { return queued_.empty(); }
+
+  // Returns the number of tabs loading, including stuck ones.
+  size_t loading_count() const { return loading_.size() + stuck_.size(); }
+  size_t stuck_count() const { return stuck_.size(); }
+
+ private:
+  // The tabs to load, ordered by descending GetLastUsedTime().
+  std::list<content::NavigationController*> queued_;
+
+  // The tabs loading that still count against |max_loads_|.
+  std::set<content::NavigationController*> loading_;
+
+  // The tabs loading that were considered stuck.
+  std::set<content::NavigationController*> stuck_;
+
+  const size_t max_loads_;
+
+  // True if the force load timer last fired with |max_loads_| tabs loading,
+  // and no load has started or finished since.
+  bool stalled_;
+
+  DISALLOW_COPY_AND_ASSIGN(TabLoadQueue);
+};
+
+#endif  // CHROME_BROWSER_SESSIONS_TAB_LOAD_QUEUE_H_
@@ -0,0 +1,127 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/sessions/tab_load_queue.h"
+
+#include "base/memory/scoped_vector.h"
+#include "base/time/time.h"
+#include "chrome/test/base/chrome_render_view_host_test_harness.h"
+#include "content/public/browser/navigation_controller.h"
+#include "content/public/browser/navigation_entry.h"
+#include "content/public/browser/web_contents.h"
+#include "content/public/test/web_contents_tester.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+using content::NavigationController;
+
+class TabLoadQueueTest : public ChromeRenderViewHostTestHarness {
+ protected:
+  void TearDown() override {
+    tabs_.clear();
+    ChromeRenderViewHostTestHarness::TearDown();
+  }
+
+  // Returns the controller of a new tab whose current entry was navigated to
+  // |last_used| seconds after the epoch.
+  NavigationController* CreateTab(time_t last_used) {
+    content::WebContents* contents = CreateTestWebContents();
+    tabs_.push_back(contents);
+    content::WebContentsTester::For(contents)->NavigateAndCommit(
+        GURL("http://www.google.com"));
+    contents->GetController().GetLastCommittedEntry()->SetTimestamp(
+        base::Time::FromTimeT(last_used));
+    return &contents->GetController();
+  }
+
+ private:
+  ScopedVector<content::WebContents> tabs_;
+};
+
+TEST_F(TabLoadQueueTest, MostRecentlyUsedFirst) {
+  NavigationController* tab1 = CreateTab(1);
+  NavigationController* tab2 = CreateTab(3);
+  NavigationController* tab3 = CreateTab(2);
+  NavigationController* tab4 = CreateTab(3);
+
+  TabLoadQueue queue(1);
+  queue.Add(tab1);
+  queue.Add(tab2);
+  queue.Add(tab3);
+  queue.Add(tab4);
+  EXPECT_TRUE(queue.IsQueued(tab4));
+
+  // Tabs used at the same time keep the order they were added in.
+  EXPECT_EQ(tab2, queue.Pop());
+  EXPECT_EQ(tab4, queue.Pop());
+  EXPECT_EQ(tab3, queue.Pop());
+  EXPECT_EQ(tab1, queue.Pop());
+  EXPECT_TRUE(queue.empty());
+  EXPECT_FALSE(queue.Pop());
+}
+
+TEST_F(TabLoadQueueTest, LimitsLoadsStartedOnTimeout) {
+  NavigationController* tab1 = CreateTab(1);
+  NavigationController* tab2 = CreateTab(1);
+
+  TabLoadQueue queue(2);
+  queue.AddLoading(tab1);
+  EXPECT_TRUE(queue.OnForceLoadTimeout());
+
+  queue.AddLoading(tab2);
+  EXPECT_EQ(2u, queue.loading_count());
+  EXPECT_FALSE(queue.OnForceLoadTimeout());
+
+  // A tab finishing loading makes room for another load.
+  queue.Remove(tab1);
+  EXPECT_FALSE(queue.IsLoading(tab1));
+  EXPECT_TRUE(queue.OnForceLoadTimeout());
+}
+
+TEST_F(TabLoadQueueTest, StopsWaitingForStuckLoads) {
+  NavigationController* tab1 = CreateTab(1);
+  NavigationController* tab2 = CreateTab(1);
+
+  TabLoadQueue queue(1);
+  queue.AddLoading(tab1);
+  EXPECT_FALSE(queue.OnForceLoadTimeout());
+
+  // No load made progress for a second timeout, so |tab1| no longer counts
+  // against the limit, though it is still loading.
+  EXPECT_TRUE(queue.OnForceLoadTimeout());
+  EXPECT_TRUE(queue.IsLoading(tab1));
+  EXPECT_EQ(1u, queue.loading_count());
+  EXPECT_EQ(1u, queue.stuck_count());
+
+  // A new load gets two timeouts of its own.
+  queue.AddLoading(tab2);
+  EXPECT_FALSE(queue.OnForceLoadTimeout());
+  EXPECT_TRUE(queue.OnForceLoadTimeout());
+  EXPECT_EQ(2u, queue.stuck_count());
+}
+
+TEST_F(TabLoadQueueTest, StuckTabFinishesAfterQueueDrains) {
+  NavigationController* tab1 = CreateTab(2);
+  NavigationController* tab2 = CreateTab(1);
+
+  TabLoadQueue queue(1);
+  queue.Add(tab1);
+  queue.Add(tab2);
+  queue.AddLoading(queue.Pop());
+  EXPECT_FALSE(queue.OnForceLoadTimeout());
+  EXPECT_TRUE(queue.OnForceLoadTimeout());
+
+  queue.AddLoading(queue.Pop());
+  EXPECT_TRUE(queue.empty());
+  queue.Remove(tab2);
+
+  // The restore isn't done while the stuck tab is still loading.
+  EXPECT_TRUE(queue.IsLoading(tab1));
+  EXPECT_EQ(1u, queue.loading_count());
+
+  queue.Remove(tab1);
+  EXPECT_FALSE(queue.IsLoading(tab1));
+  EXPECT_EQ(0u, queue.loading_count());
+  EXPECT_EQ(0u, queue.stuck_count());
+}
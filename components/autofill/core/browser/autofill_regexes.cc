@@ -4,30 +4,57 @@
 
 #include "components/autofill/core/browser/autofill_regexes.h"
 
-#include "base/containers/scoped_ptr_hash_map.h"
+#include <utility>
+#include <vector>
+
+#include "base/containers/hash_tables.h"
+#include "base/containers/mru_cache.h"
 #include "base/logging.h"
-#include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
 #include "base/memory/singleton.h"
 #include "base/strings/string16.h"
 #include "third_party/icu/source/i18n/unicode/regex.h"
 
 namespace {
 
-// A singleton class that serves as a cache of compiled regex patterns.
+// Number of inputs whose match results AutofillRegexes keeps. Even forms with
+// hundreds of fields have fewer distinct labels and names than this.
+const size_t kMaxCachedInputs = 1000;
+
+// A singleton class that serves as a cache of compiled regex patterns, and of
+// the results of recently matching them.
 class AutofillRegexes {
  public:
   static AutofillRegexes* GetInstance();
 
-  // Returns the compiled regex matcher corresponding to |pattern|.
-  icu::RegexMatcher* GetMatcher(const base::string16& pattern);
+  // Returns true if |pattern| is found in |input|.
+  bool Matches(const base::string16& input, const base::string16& pattern);
 
  private:
   AutofillRegexes();
   ~AutofillRegexes();
   friend struct DefaultSingletonTraits<AutofillRegexes>;
 
-  // Maps patterns to their corresponding regex matchers.
-  base::ScopedPtrHashMap<base::string16, icu::RegexMatcher> matchers_;
+  enum MatchResult {
+    MATCH_UNKNOWN,
+    MATCH_FOUND,
+    MATCH_NOT_FOUND,
+  };
+
+  // Returns the index in |matchers_| of the compiled regex matcher
+  // corresponding to |pattern|.
+  size_t GetMatcherIndex(const base::string16& pattern);
+
+  // Maps patterns to the index of their regex matchers in |matchers_|.
+  base::hash_map<base::string16, size_t> matcher_indexes_;
+  ScopedVector<icu::RegexMatcher> matchers_;
+
+  // Results of matching recent inputs against each pattern, indexed like
+  // |matchers_|. The heuristics try the same few dozen patterns against the
+  // label and name of every field, and labels repeat a lot within large
+  // forms, as do labels and names when a page's forms are parsed again.
+  typedef std::vector<MatchResult> MatchResults;
+  base::HashingMRUCache<base::string16, MatchResults> match_results_;
 
   DISALLOW_COPY_AND_ASSIGN(AutofillRegexes);
 };
@@ -37,44 +64,60 @@ AutofillRegexes* AutofillRegexes::GetInstance() {
   return Singleton<AutofillRegexes>::get();
 }
 
-AutofillRegexes::AutofillRegexes() {
+AutofillRegexes::AutofillRegexes()
+    : match_results_(kMaxCachedInputs) {
 }
 
 AutofillRegexes::~AutofillRegexes() {
 }
 
-icu::RegexMatcher* AutofillRegexes::GetMatcher(const base::string16& pattern) {
-  auto it = matchers_.find(pattern);
-  if (it == matchers_.end()) {
+size_t AutofillRegexes::GetMatcherIndex(const base::string16& pattern) {
+  auto it = matcher_indexes_.find(pattern);
+  if (it == matcher_indexes_.end()) {
     const icu::UnicodeString icu_pattern(pattern.data(), pattern.length());
 
     UErrorCode status = U_ZERO_ERROR;
-    scoped_ptr<icu::RegexMatcher> matcher(
+    matchers_.push_back(
         new icu::RegexMatcher(icu_pattern, UREGEX_CASE_INSENSITIVE, status));
     DCHECK(U_SUCCESS(status));
 
-    auto result = matchers_.add(pattern, matcher.Pass());
-    DCHECK(result.second);
-    it = result.first;
+    it = matcher_indexes_.insert(
+        std::make_pair(pattern, matchers_.size() - 1)).first;
   }
   return it->second;
 }
 
-}  // namespace
-
-namespace autofill {
-
-bool MatchesPattern(const base::string16& input,
-                    const base::string16& pattern) {
-  icu::RegexMatcher* matcher =
-      AutofillRegexes::GetInstance()->GetMatcher(pattern);
+bool AutofillRegexes::Matches(const base::string16& input,
+                              const base::string16& pattern) {
+  const size_t index = GetMatcherIndex(pattern);
+  base::HashingMRUCache<base::string16, MatchResults>::iterator cached =
+      match_results_.Get(input);
+  if (cached == match_results_.end())
+    cached = match_results_.Put(input, MatchResults());
+  MatchResults& results = cached->second;
+  if (results.size() <= index)
+    results.resize(matchers_.size(), MATCH_UNKNOWN);
+  if (results[index] != MATCH_UNKNOWN)
+    return results[index] == MATCH_FOUND;
+
+  icu::RegexMatcher* matcher = matchers_[index];
   icu::UnicodeString icu_input(input.data(), input.length());
   matcher->reset(icu_input);
 
   UErrorCode status = U_ZERO_ERROR;
   UBool match = matcher->find(0, status);
   DCHECK(U_SUCCESS(status));
+  results[index] = match ? MATCH_FOUND : MATCH_NOT_FOUND;
   return match == TRUE;
 }
 
+}  // namespace
+
+namespace autofill {
+
+bool MatchesPattern(const base::string16& input,
+                    const base::string16& pattern) {
+  return AutofillRegexes::GetInstance()->Matches(input, pattern);
+}
+
 }  // namespace autofill
@@ -5,6 +5,7 @@
 #include "components/autofill/core/browser/autofill_regexes.h"
 
 #include "base/strings/string16.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/utf_string_conversions.h"
 #include "components/autofill/core/browser/autofill_regex_constants.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -13,27 +14,43 @@ using base::ASCIIToUTF16;
 
 namespace autofill {
 
-TEST(AutofillRegexesTest, AutofillRegexes) {
-  struct TestCase {
-    const char* const input;
-    const char* const pattern;
-  };
+namespace {
+
+struct TestCase {
+  const char* const input;
+  const char* const pattern;
+};
+
+const TestCase kPositiveCases[] = {
+  // Empty pattern
+  {"", ""},
+  {"Look, ma' -- a non-empty string!", ""},
+  // Substring
+  {"string", "tri"},
+  // Substring at beginning
+  {"string", "str"},
+  {"string", "^str"},
+  // Substring at end
+  {"string", "ring"},
+  {"string", "ring$"},
+  // Case-insensitive
+  {"StRiNg", "string"},
+};
+
+const TestCase kNegativeCases[] = {
+  // Empty string
+  {"", "Look, ma' -- a non-empty pattern!"},
+  // Substring
+  {"string", "trn"},
+  // Substring at beginning
+  {"string", " str"},
+  {"string", "^tri"},
+  // Substring at end
+  {"string", "ring "},
+  {"string", "rin$"},
+};
 
-  const TestCase kPositiveCases[] = {
-    // Empty pattern
-    {"", ""},
-    {"Look, ma' -- a non-empty string!", ""},
-    // Substring
-    {"string", "tri"},
-    // Substring at beginning
-    {"string", "str"},
-    {"string", "^str"},
-    // Substring at end
-    {"string", "ring"},
-    {"string", "ring$"},
-    // Case-insensitive
-    {"StRiNg", "string"},
-  };
+void CheckTestCases() {
   for (size_t i = 0; i < arraysize(kPositiveCases); ++i) {
     const TestCase& test_case = kPositiveCases[i];
     SCOPED_TRACE(test_case.input);
@@ -41,19 +58,6 @@ TEST(AutofillRegexesTest, AutofillRegexes) {
     EXPECT_TRUE(autofill::MatchesPattern(ASCIIToUTF16(test_case.input),
                                          ASCIIToUTF16(test_case.pattern)));
   }
-
-  const TestCase kNegativeCases[] = {
-    // Empty string
-    {"", "Look, ma' -- a non-empty pattern!"},
-    // Substring
-    {"string", "trn"},
-    // Substring at beginning
-    {"string", " str"},
-    {"string", "^tri"},
-    // Substring at end
-    {"string", "ring "},
-    {"string", "rin$"},
-  };
   for (size_t i = 0; i < arraysize(kNegativeCases); ++i) {
     const TestCase& test_case = kNegativeCases[i];
     SCOPED_TRACE(test_case.input);
@@ -63,4 +67,32 @@ TEST(AutofillRegexesTest, AutofillRegexes) {
   }
 }
 
+}  // namespace
+
+TEST(AutofillRegexesTest, AutofillRegexes) {
+  // Results are cached, so the second pass checks that cached results agree
+  // with the original ones.
+  for (int pass = 0; pass < 2; ++pass) {
+    SCOPED_TRACE(pass);
+    CheckTestCases();
+  }
+}
+
+TEST(AutofillRegexesTest, CacheEviction) {
+  CheckTestCases();
+
+  // Match more distinct inputs than the cache holds, which evicts the results
+  // for the test cases above.
+  const base::string16 digits = ASCIIToUTF16("^string\\d+$");
+  const base::string16 no_digits = ASCIIToUTF16("^string$");
+  for (int i = 0; i < 5000; ++i) {
+    const base::string16 input =
+        ASCIIToUTF16("string") + base::IntToString16(i);
+    EXPECT_TRUE(autofill::MatchesPattern(input, digits));
+    EXPECT_FALSE(autofill::MatchesPattern(input, no_digits));
+  }
+
+  CheckTestCases();
+}
+
 }  // namespace autofill
@@ -0,0 +1,85 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "components/autofill/core/browser/form_structure.h"
+
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/strings/stringprintf.h"
+#include "base/strings/utf_string_conversions.h"
+#include "base/time/time.h"
+#include "components/autofill/core/common/form_data.h"
+#include "components/autofill/core/common/form_field_data.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+#include "url/gurl.h"
+
+using base::ASCIIToUTF16;
+
+namespace autofill {
+
+namespace {
+
+const int kNumIterations = 20;
+
+// Labels of a typical address and payment block, repeated to build large
+// forms such as multi-recipient checkouts or order sheets.
+const char* const kFieldLabels[] = {
+  "First name", "Last name", "Company", "Address line 1", "Address line 2",
+  "City", "State", "ZIP code", "Country", "Phone number", "Email",
+  "Quantity", "Gift message", "Name on card", "Card number",
+  "Expiration date", "Security code",
+};
+
+// Returns a form with |num_blocks| copies of kFieldLabels. Field names are
+// unique, as they are on real pages.
+FormData CreateForm(int num_blocks) {
+  FormData form;
+  form.name = ASCIIToUTF16("checkout");
+  form.origin = GURL("https://www.example.com/checkout");
+  form.action = GURL("https://www.example.com/submit");
+  form.user_submitted = false;
+
+  FormFieldData field;
+  field.form_control_type = "text";
+  for (int block = 0; block < num_blocks; ++block) {
+    for (size_t i = 0; i < arraysize(kFieldLabels); ++i) {
+      field.label = ASCIIToUTF16(kFieldLabels[i]);
+      field.name = ASCIIToUTF16(base::StringPrintf(
+          "recipient%d_field%d", block, static_cast<int>(i)));
+      form.fields.push_back(field);
+    }
+  }
+  return form;
+}
+
+void RunHeuristics(int num_blocks) {
+  const FormData form = CreateForm(num_blocks);
+
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kNumIterations; ++i) {
+    FormStructure form_structure(form);
+    form_structure.DetermineHeuristicTypes();
+  }
+  base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+
+  perf_test::PrintResult(
+      "autofill_heuristics",
+      base::StringPrintf("_%d_fields", static_cast<int>(form.fields.size())),
+      "determine_heuristic_types",
+      elapsed.InMillisecondsF() / kNumIterations, "ms", true);
+}
+
+}  // namespace
+
+TEST(FormStructurePerfTest, SmallForm) {
+  RunHeuristics(1);
+}
+
+TEST(FormStructurePerfTest, LargeForm) {
+  RunHeuristics(20);
+}
+
+}  // namespace autofill
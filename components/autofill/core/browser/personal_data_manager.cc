@@ -281,10 +281,12 @@ void PersonalDataManager::OnWebDataServiceRequestDone(
       if (h == pending_profiles_query_) {
         ReceiveLoadedDBvalues(h, result, &pending_profiles_query_,
                               &web_profiles_);
+        value_indexes_.clear();
         LogProfileCount();  // This only logs local profiles.
       } else {
         ReceiveLoadedDBvalues(h, result, &pending_server_profiles_query_,
                               &server_profiles_);
+        value_indexes_.clear();
       }
       break;
     case AUTOFILL_CREDITCARDS_RESULT:
@@ -712,25 +714,30 @@ std::vector<Suggestion> PersonalDataManager::GetProfileSuggestions(
       }
     }
   } else {
-    // Match based on a prefix search.
+    // Match based on a prefix search. Values sharing the prefix are adjacent
+    // in the sorted index, starting at the first one not less than it.
+    const std::vector<AutofillProfile*>& profiles = GetProfiles(true);
+    const ValueIndex& index = GetValueIndex(type, profiles);
+    IndexedValue key;
+    key.canon_value = field_contents_canon;
+    // Keyed by (profile index, variant) so that the matches are suggested in
+    // profile order, as they were before the index existed.
+    std::map<std::pair<size_t, size_t>, const base::string16*> matches;
+    for (ValueIndex::const_iterator it =
+             std::lower_bound(index.begin(), index.end(), key);
+         it != index.end() &&
+         StartsWith(it->canon_value, field_contents_canon, true);
+         ++it) {
+      matches[std::make_pair(it->profile_index, it->variant)] = &it->value;
+    }
+
     std::vector<AutofillProfile*> matched_profiles;
-    for (AutofillProfile* profile : GetProfiles(true)) {
-      std::vector<base::string16> values =
-          GetMultiInfoInOneLine(profile, type, app_locale_);
-      for (size_t i = 0; i < values.size(); i++) {
-        if (values[i].empty())
-          continue;
-
-        base::string16 value_canon =
-            AutofillProfile::CanonicalizeProfileString(values[i]);
-        if (StartsWith(value_canon, field_contents_canon, true)) {
-          // Prefix match, add suggestion.
-          matched_profiles.push_back(profile);
-          suggestions.push_back(Suggestion(values[i]));
-          suggestions.back().backend_id.guid = profile->guid();
-          suggestions.back().backend_id.variant = i;
-        }
-      }
+    for (const auto& match : matches) {
+      AutofillProfile* profile = profiles[match.first.first];
+      matched_profiles.push_back(profile);
+      suggestions.push_back(Suggestion(*match.second));
+      suggestions.back().backend_id.guid = profile->guid();
+      suggestions.back().backend_id.variant = match.first.second;
     }
 
     // Generate disambiguating labels based on the list of matches.
@@ -746,6 +753,40 @@ std::vector<Suggestion> PersonalDataManager::GetProfileSuggestions(
   return suggestions;
 }
 
+const PersonalDataManager::ValueIndex& PersonalDataManager::GetValueIndex(
+    const AutofillType& type,
+    const std::vector<AutofillProfile*>& profiles) {
+  // Auxiliary profiles are recreated by every GetProfiles() call, so there is
+  // nothing to reuse while they are in the list.
+  if (profiles != indexed_profiles_ || !auxiliary_profiles_.empty()) {
+    value_indexes_.clear();
+    indexed_profiles_ = profiles;
+  }
+
+  ValueIndexKey key(type.ToString(), type.group());
+  std::map<ValueIndexKey, ValueIndex>::iterator it = value_indexes_.find(key);
+  if (it != value_indexes_.end())
+    return it->second;
+
+  ValueIndex& index = value_indexes_[key];
+  for (size_t i = 0; i < profiles.size(); ++i) {
+    std::vector<base::string16> values =
+        GetMultiInfoInOneLine(profiles[i], type, app_locale_);
+    for (size_t j = 0; j < values.size(); ++j) {
+      if (values[j].empty())
+        continue;
+      IndexedValue entry;
+      entry.canon_value = AutofillProfile::CanonicalizeProfileString(values[j]);
+      entry.value = values[j];
+      entry.profile_index = i;
+      entry.variant = j;
+      index.push_back(entry);
+    }
+  }
+  std::sort(index.begin(), index.end());
+  return index;
+}
+
 std::vector<Suggestion> PersonalDataManager::GetCreditCardSuggestions(
     const AutofillType& type,
     const base::string16& field_contents) {
@@ -980,6 +1021,7 @@ void PersonalDataManager::SetProfiles(std::vector<AutofillProfile>* profiles) {
   }
 
   // Copy in the new profiles.
+  value_indexes_.clear();
   web_profiles_.clear();
   for (std::vector<AutofillProfile>::iterator iter = profiles->begin();
        iter != profiles->end(); ++iter) {
@@ -5,7 +5,10 @@
 #ifndef COMPONENTS_AUTOFILL_CORE_BROWSER_PERSONAL_DATA_MANAGER_H_
 #define COMPONENTS_AUTOFILL_CORE_BROWSER_PERSONAL_DATA_MANAGER_H_
 
+#include <map>
 #include <set>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "base/basictypes.h"
@@ -324,6 +327,30 @@ class PersonalDataManager : public KeyedService,
   ObserverList<PersonalDataManagerObserver> observers_;
 
  private:
+  // A non-empty value of one field type in one profile. See GetValueIndex().
+  struct IndexedValue {
+    bool operator<(const IndexedValue& other) const {
+      return canon_value < other.canon_value;
+    }
+
+    // |value| canonicalized with AutofillProfile::CanonicalizeProfileString().
+    base::string16 canon_value;
+    base::string16 value;
+    // The index of the profile in |indexed_profiles_|.
+    size_t profile_index;
+    // The index of |value| among the profile's values for the type.
+    size_t variant;
+  };
+  typedef std::vector<IndexedValue> ValueIndex;
+  typedef std::pair<std::string, FieldTypeGroup> ValueIndexKey;
+
+  // Returns the values of |type| across |profiles|, sorted by |canon_value|
+  // so that prefix matches can be found with a binary search. The index is
+  // built on first use and kept until the profiles change.
+  const ValueIndex& GetValueIndex(
+      const AutofillType& type,
+      const std::vector<AutofillProfile*>& profiles);
+
   // Finds the country code that occurs most frequently among all profiles.
   // Prefers verified profiles over unverified ones.
   std::string MostCommonCountryCodeFromProfiles() const;
@@ -355,6 +382,13 @@ class PersonalDataManager : public KeyedService,
   // An observer to listen for changes to prefs::kAutofillEnabled.
   scoped_ptr<BooleanPrefMember> enabled_pref_;
 
+  // Value indexes built by GetValueIndex(), keyed by the string and group of
+  // their AutofillType. Cleared whenever the loaded profiles are replaced.
+  std::map<ValueIndexKey, ValueIndex> value_indexes_;
+
+  // The profiles |value_indexes_| were built from.
+  std::vector<AutofillProfile*> indexed_profiles_;
+
   DISALLOW_COPY_AND_ASSIGN(PersonalDataManager);
 };
 
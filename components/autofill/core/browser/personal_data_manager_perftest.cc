@@ -0,0 +1,106 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "components/autofill/core/browser/personal_data_manager.h"
+
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/guid.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
+#include "base/message_loop/message_loop.h"
+#include "base/prefs/pref_service.h"
+#include "base/strings/stringprintf.h"
+#include "base/strings/utf_string_conversions.h"
+#include "base/time/time.h"
+#include "components/autofill/core/browser/autofill_profile.h"
+#include "components/autofill/core/browser/autofill_test_utils.h"
+#include "components/autofill/core/browser/autofill_type.h"
+#include "components/autofill/core/browser/suggestion.h"
+#include "components/autofill/core/browser/test_personal_data_manager.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+using base::ASCIIToUTF16;
+
+namespace autofill {
+
+namespace {
+
+const int kNumIterations = 20;
+
+// What a user types into a street address field, one keystroke at a time.
+const char* const kKeystrokes[] = { "1", "12", "123", "1234" };
+
+class PerfPersonalDataManager : public TestPersonalDataManager {
+ public:
+  using PersonalDataManager::SetPrefService;
+};
+
+void RunProfileSuggestions(int num_profiles) {
+  base::MessageLoop message_loop;
+  scoped_ptr<PrefService> prefs = test::PrefServiceForTesting();
+  test::DisableSystemServices(prefs.get());
+  PerfPersonalDataManager personal_data;
+  personal_data.SetPrefService(prefs.get());
+
+  // Profiles with distinct names and addresses, as accumulated by a user who
+  // has filled in many forms over the years.
+  ScopedVector<AutofillProfile> profiles;
+  for (int i = 0; i < num_profiles; ++i) {
+    AutofillProfile* profile =
+        new AutofillProfile(base::GenerateGUID(), "https://www.example.com");
+    test::SetProfileInfo(profile,
+        base::StringPrintf("First%d", i).c_str(), "",
+        base::StringPrintf("Last%d", i).c_str(),
+        base::StringPrintf("user%d@example.com", i).c_str(), "Company",
+        base::StringPrintf("%d Main St.", i).c_str(), "", "Springfield",
+        "CA", "90210", "US", "16505550100");
+    profiles.push_back(profile);
+    personal_data.AddTestingProfile(profile);
+  }
+
+  const AutofillType type(ADDRESS_HOME_LINE1);
+  const std::vector<ServerFieldType> other_field_types;
+
+  // The first keystroke includes building any per-type state.
+  base::TimeTicks start = base::TimeTicks::Now();
+  std::vector<Suggestion> suggestions = personal_data.GetProfileSuggestions(
+      type, ASCIIToUTF16(kKeystrokes[0]), false, other_field_types);
+  base::TimeDelta first = base::TimeTicks::Now() - start;
+  EXPECT_FALSE(suggestions.empty());
+
+  start = base::TimeTicks::Now();
+  for (int i = 0; i < kNumIterations; ++i) {
+    for (size_t j = 0; j < arraysize(kKeystrokes); ++j) {
+      personal_data.GetProfileSuggestions(
+          type, ASCIIToUTF16(kKeystrokes[j]), false, other_field_types);
+    }
+  }
+  base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+
+  const std::string trace =
+      base::StringPrintf("_%d_profiles", num_profiles);
+  perf_test::PrintResult("autofill_profile_suggestions", trace,
+                         "first_keystroke", first.InMillisecondsF(), "ms",
+                         true);
+  perf_test::PrintResult(
+      "autofill_profile_suggestions", trace, "keystroke",
+      elapsed.InMillisecondsF() / (kNumIterations * arraysize(kKeystrokes)),
+      "ms", true);
+}
+
+}  // namespace
+
+TEST(PersonalDataManagerPerfTest, FewProfiles) {
+  RunProfileSuggestions(10);
+}
+
+TEST(PersonalDataManagerPerfTest, ThousandsOfProfiles) {
+  RunProfileSuggestions(5000);
+}
+
+}  // namespace autofill
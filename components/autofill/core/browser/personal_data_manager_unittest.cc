@@ -2710,6 +2710,56 @@ TEST_F(PersonalDataManagerTest, GetProfileSuggestions) {
       base::UTF8ToUTF16("123 Zoo St., Second Line, Third line, unit 5"));
 }
 
+// Tests that prefix suggestions follow changes to the stored profiles.
+TEST_F(PersonalDataManagerTest, GetProfileSuggestionsAfterUpdate) {
+  AutofillProfile profile0(base::GenerateGUID(), "https://www.example.com");
+  test::SetProfileInfo(&profile0,
+      "Marion", "Mitchell", "Morrison",
+      "johnwayne@me.xyz", "Fox",
+      "123 Zoo St.", "unit 5", "Hollywood", "CA",
+      "91601", "US", "12345678910");
+  personal_data_->AddProfile(profile0);
+  ResetPersonalDataManager(USER_MODE_NORMAL);
+
+  std::vector<Suggestion> suggestions = personal_data_->GetProfileSuggestions(
+      AutofillType(NAME_FIRST), base::ASCIIToUTF16("mar"), false,
+      std::vector<ServerFieldType>());
+  ASSERT_EQ(1U, suggestions.size());
+  EXPECT_EQ(base::ASCIIToUTF16("Marion"), suggestions[0].value);
+
+  // Rename the profile and add a second one sharing the prefix.
+  AutofillProfile profile1(base::GenerateGUID(), "https://www.example.com");
+  test::SetProfileInfo(&profile1,
+      "Mary", "", "Bloggs",
+      "mary@example.com", "", "", "", "", "", "", "", "");
+  profile0.SetRawInfo(NAME_FIRST, base::ASCIIToUTF16("Martin"));
+  personal_data_->UpdateProfile(profile0);
+  personal_data_->AddProfile(profile1);
+
+  EXPECT_CALL(personal_data_observer_, OnPersonalDataChanged())
+      .WillOnce(QuitMainMessageLoop());
+  base::MessageLoop::current()->Run();
+
+  suggestions = personal_data_->GetProfileSuggestions(
+      AutofillType(NAME_FIRST), base::ASCIIToUTF16("mar"), false,
+      std::vector<ServerFieldType>());
+  ASSERT_EQ(2U, suggestions.size());
+  const std::vector<AutofillProfile*>& profiles = personal_data_->GetProfiles();
+  ASSERT_EQ(2U, profiles.size());
+  for (size_t i = 0; i < profiles.size(); ++i) {
+    EXPECT_EQ(profiles[i]->guid(), suggestions[i].backend_id.guid);
+    EXPECT_EQ(profiles[i]->GetRawInfo(NAME_FIRST), suggestions[i].value);
+  }
+  EXPECT_NE(suggestions[0].value, base::ASCIIToUTF16("Marion"));
+  EXPECT_NE(suggestions[1].value, base::ASCIIToUTF16("Marion"));
+
+  suggestions = personal_data_->GetProfileSuggestions(
+      AutofillType(NAME_FIRST), base::ASCIIToUTF16("mary"), false,
+      std::vector<ServerFieldType>());
+  ASSERT_EQ(1U, suggestions.size());
+  EXPECT_EQ(profile1.guid(), suggestions[0].backend_id.guid);
+}
+
 TEST_F(PersonalDataManagerTest, GetCreditCardSuggestions) {
   EnableWalletCardImport();
 
@@ -13,7 +13,6 @@
 #include "base/metrics/histogram.h"
 #include "base/pickle.h"
 #include "base/profiler/scoped_tracker.h"
-#include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
 #include "base/time/time.h"
 #include "components/autofill/core/common/password_form.h"
@@ -157,7 +156,7 @@ void LogTimesUsedStat(const std::string& name, int sample) {
 
 }  // namespace
 
-LoginDatabase::LoginDatabase() {
+LoginDatabase::LoginDatabase() : realm_index_built_(false) {
 }
 
 LoginDatabase::~LoginDatabase() {
@@ -465,6 +464,7 @@ PasswordStoreChangeList LoginDatabase::AddLogin(const PasswordForm& form) {
   const bool success = s.Run();
   db_.reset_error_callback();
   if (success) {
+    AddRealmToIndex(form.signon_realm);
     list.push_back(PasswordStoreChange(PasswordStoreChange::ADD, form));
     return list;
   }
@@ -480,6 +480,7 @@ PasswordStoreChangeList LoginDatabase::AddLogin(const PasswordForm& form) {
       "(?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)"));
   BindAddStatement(form, encrypted_password, &s);
   if (s.Run()) {
+    AddRealmToIndex(form.signon_realm);
     list.push_back(PasswordStoreChange(PasswordStoreChange::REMOVE, form));
     list.push_back(PasswordStoreChange(PasswordStoreChange::ADD, form));
   }
@@ -662,95 +663,118 @@ LoginDatabase::EncryptionResult LoginDatabase::InitPasswordFormFromStatement(
 bool LoginDatabase::GetLogins(const PasswordForm& form,
                               std::vector<PasswordForm*>* forms) const {
   DCHECK(forms);
-  // You *must* change LoginTableColumns if this query changes.
-  const std::string sql_query = "SELECT origin_url, action_url, "
-      "username_element, username_value, "
-      "password_element, password_value, submit_element, "
-      "signon_realm, ssl_valid, preferred, date_created, blacklisted_by_user, "
-      "scheme, password_type, possible_usernames, times_used, form_data, "
-      "date_synced, display_name, avatar_url, "
-      "federation_url, is_zero_click FROM logins WHERE signon_realm == ? ";
-  sql::Statement s;
   const GURL signon_realm(form.signon_realm);
   std::string registered_domain = GetRegistryControlledDomain(signon_realm);
   PSLDomainMatchMetric psl_domain_match_metric = PSL_DOMAIN_MATCH_NONE;
   const bool should_PSL_matching_apply =
       form.scheme == PasswordForm::SCHEME_HTML &&
       ShouldPSLDomainMatchingApply(registered_domain);
-  // PSL matching only applies to HTML forms.
+  // The realms whose logins are loaded. Besides the exact realm of |form|,
+  // PSL matching (which only applies to HTML forms) adds any stored realm
+  // with the same scheme, registry controlled domain and port. Those are
+  // found in |realms_by_domain_|, so only logins which actually match are
+  // read and have their passwords decrypted.
+  std::vector<std::string> realms(1, form.signon_realm);
   if (should_PSL_matching_apply) {
-    // We are extending the original SQL query with one that includes more
-    // possible matches based on public suffix domain matching. Using a regexp
-    // here is just an optimization to not have to parse all the stored entries
-    // in the |logins| table. The result (scheme, domain and port) is verified
-    // further down using GURL. See the functions SchemeMatches,
-    // RegistryControlledDomainMatches and PortMatches.
-    const std::string extended_sql_query =
-        sql_query + "OR signon_realm REGEXP ? ";
-    // TODO(nyquist) Re-enable usage of GetCachedStatement when
-    // http://crbug.com/248608 is fixed.
-    s.Assign(db_.GetUniqueStatement(extended_sql_query.c_str()));
-    // We need to escape . in the domain. Since the domain has already been
-    // sanitized using GURL, we do not need to escape any other characters.
-    base::ReplaceChars(registered_domain, ".", "\\.", &registered_domain);
-    std::string scheme = signon_realm.scheme();
-    // We need to escape . in the scheme. Since the scheme has already been
-    // sanitized using GURL, we do not need to escape any other characters.
-    // The scheme soap.beep is an example with '.'.
-    base::ReplaceChars(scheme, ".", "\\.", &scheme);
-    const std::string port = signon_realm.port();
-    // For a signon realm such as http://foo.bar/, this regexp will match
-    // domains on the form http://foo.bar/, http://www.foo.bar/,
-    // http://www.mobile.foo.bar/. It will not match http://notfoo.bar/.
-    // The scheme and port has to be the same as the observed form.
-    std::string regexp = "^(" + scheme + ":\\/\\/)([\\w-]+\\.)*" +
-                         registered_domain + "(:" + port + ")?\\/$";
-    s.BindString(0, form.signon_realm);
-    s.BindString(1, regexp);
+    if (!GetPSLMatchingRealms(form.signon_realm, registered_domain, &realms))
+      return false;
   } else {
     psl_domain_match_metric = PSL_DOMAIN_MATCH_NOT_USED;
-    s.Assign(db_.GetCachedStatement(SQL_FROM_HERE, sql_query.c_str()));
-    s.BindString(0, form.signon_realm);
   }
 
-  while (s.Step()) {
-    scoped_ptr<PasswordForm> new_form(new PasswordForm());
-    EncryptionResult result = InitPasswordFormFromStatement(new_form.get(), s);
-    if (result == ENCRYPTION_RESULT_SERVICE_FAILURE)
-      return false;
-    if (result == ENCRYPTION_RESULT_ITEM_FAILURE)
-      continue;
-    DCHECK(result == ENCRYPTION_RESULT_SUCCESS);
-    if (should_PSL_matching_apply) {
-      if (!IsPublicSuffixDomainMatch(new_form->signon_realm,
-                                     form.signon_realm)) {
-        // The database returned results that should not match. Skipping result.
+  // You *must* change LoginTableColumns if this query changes.
+  sql::Statement s(db_.GetCachedStatement(SQL_FROM_HERE,
+      "SELECT origin_url, action_url, "
+      "username_element, username_value, "
+      "password_element, password_value, submit_element, "
+      "signon_realm, ssl_valid, preferred, date_created, blacklisted_by_user, "
+      "scheme, password_type, possible_usernames, times_used, form_data, "
+      "date_synced, display_name, avatar_url, "
+      "federation_url, is_zero_click FROM logins WHERE signon_realm == ?"));
+  for (size_t i = 0; i < realms.size(); ++i) {
+    s.Reset(true);
+    s.BindString(0, realms[i]);
+    while (s.Step()) {
+      scoped_ptr<PasswordForm> new_form(new PasswordForm());
+      EncryptionResult result =
+          InitPasswordFormFromStatement(new_form.get(), s);
+      if (result == ENCRYPTION_RESULT_SERVICE_FAILURE)
+        return false;
+      if (result == ENCRYPTION_RESULT_ITEM_FAILURE)
         continue;
-      }
+      DCHECK(result == ENCRYPTION_RESULT_SUCCESS);
       if (form.signon_realm != new_form->signon_realm) {
         // Ignore non-HTML matches.
         if (new_form->scheme != PasswordForm::SCHEME_HTML)
           continue;
 
         psl_domain_match_metric = PSL_DOMAIN_MATCH_FOUND;
-        // This is not a perfect match, so we need to create a new valid result.
-        // We do this by copying over origin, signon realm and action from the
-        // observed form and setting the original signon realm to what we found
-        // in the database. We use the fact that |original_signon_realm| is
-        // non-empty to communicate that this match was found using public
-        // suffix matching.
+        // This is not a perfect match, so we need to create a new valid
+        // result. We do this by copying over origin, signon realm and action
+        // from the observed form and setting the original signon realm to
+        // what we found in the database. We use the fact that
+        // |original_signon_realm| is non-empty to communicate that this match
+        // was found using public suffix matching.
         new_form->original_signon_realm = new_form->signon_realm;
         new_form->origin = form.origin;
         new_form->signon_realm = form.signon_realm;
         new_form->action = form.action;
       }
+      forms->push_back(new_form.release());
     }
-    forms->push_back(new_form.release());
+    if (!s.Succeeded())
+      return false;
   }
   UMA_HISTOGRAM_ENUMERATION("PasswordManager.PslDomainMatchTriggering",
                             psl_domain_match_metric,
                             PSL_DOMAIN_MATCH_COUNT);
-  return s.Succeeded();
+  return true;
+}
+
+bool LoginDatabase::GetPSLMatchingRealms(
+    const std::string& signon_realm,
+    const std::string& registered_domain,
+    std::vector<std::string>* realms) const {
+  if (!realm_index_built_) {
+    sql::Statement s(db_.GetCachedStatement(SQL_FROM_HERE,
+        "SELECT DISTINCT signon_realm FROM logins"));
+    realms_by_domain_.clear();
+    realm_index_built_ = true;
+    while (s.Step())
+      AddRealmToIndex(s.ColumnString(0));
+    if (!s.Succeeded()) {
+      realms_by_domain_.clear();
+      realm_index_built_ = false;
+      return false;
+    }
+  }
+
+  std::map<std::string, std::set<std::string> >::const_iterator it =
+      realms_by_domain_.find(registered_domain);
+  if (it == realms_by_domain_.end())
+    return true;
+  for (std::set<std::string>::const_iterator realm = it->second.begin();
+       realm != it->second.end(); ++realm) {
+    if (*realm == signon_realm)
+      continue;
+    // Only realms of the form scheme://host[:port]/ are PSL matched; this
+    // excludes realms of non-HTML forms such as http://host/Realm.
+    const GURL realm_url(*realm);
+    if (realm_url.GetOrigin().spec() != *realm)
+      continue;
+    if (IsPublicSuffixDomainMatch(*realm, signon_realm))
+      realms->push_back(*realm);
+  }
+  return true;
+}
+
+void LoginDatabase::AddRealmToIndex(const std::string& signon_realm) const {
+  if (!realm_index_built_)
+    return;
+  const std::string registered_domain =
+      GetRegistryControlledDomain(GURL(signon_realm));
+  if (!registered_domain.empty())
+    realms_by_domain_[registered_domain].insert(signon_realm);
 }
 
 bool LoginDatabase::GetLoginsCreatedBetween(
@@ -858,6 +882,8 @@ bool LoginDatabase::GetAllLoginsWithBlacklistSetting(
 
 bool LoginDatabase::DeleteAndRecreateDatabaseFile() {
   DCHECK(db_.is_open());
+  realms_by_domain_.clear();
+  realm_index_built_ = false;
   meta_table_.Reset();
   db_.Close();
   sql::Connection::Delete(db_path_);
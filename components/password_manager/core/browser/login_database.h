@@ -5,6 +5,8 @@
 #ifndef COMPONENTS_PASSWORD_MANAGER_CORE_BROWSER_LOGIN_DATABASE_H_
 #define COMPONENTS_PASSWORD_MANAGER_CORE_BROWSER_LOGIN_DATABASE_H_
 
+#include <map>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -146,10 +148,29 @@ class LoginDatabase {
   bool GetAllLoginsWithBlacklistSetting(
       bool blacklisted, std::vector<autofill::PasswordForm*>* forms) const;
 
+  // Appends to |realms| the stored signon realms, other than |signon_realm|
+  // itself, which are public suffix matches for |signon_realm|. Builds
+  // |realms_by_domain_| first if needed. Returns false on a database error.
+  bool GetPSLMatchingRealms(const std::string& signon_realm,
+                            const std::string& registered_domain,
+                            std::vector<std::string>* realms) const;
+
+  // Adds |signon_realm| to |realms_by_domain_|, if it has been built.
+  void AddRealmToIndex(const std::string& signon_realm) const;
+
   base::FilePath db_path_;
   mutable sql::Connection db_;
   sql::MetaTable meta_table_;
 
+  // The distinct signon realms in the database, keyed by their registry
+  // controlled domain. This lets GetLogins() find public suffix matches with
+  // indexed lookups instead of running a regular expression over every row.
+  // Realms whose logins have all been removed are left in place; looking
+  // them up just returns no rows. Built by the first GetLogins() that needs
+  // it, on the thread the database is used on.
+  mutable std::map<std::string, std::set<std::string> > realms_by_domain_;
+  mutable bool realm_index_built_;
+
   DISALLOW_COPY_AND_ASSIGN(LoginDatabase);
 };
 
@@ -0,0 +1,81 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "components/password_manager/core/browser/login_database.h"
+
+#include <string>
+
+#include "base/files/scoped_temp_dir.h"
+#include "base/memory/scoped_vector.h"
+#include "base/strings/stringprintf.h"
+#include "base/strings/utf_string_conversions.h"
+#include "base/time/time.h"
+#include "components/autofill/core/common/password_form.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+#include "url/gurl.h"
+
+using autofill::PasswordForm;
+using base::ASCIIToUTF16;
+
+namespace password_manager {
+
+namespace {
+
+const int kNumLogins = 10000;
+const int kNumLookups = 1000;
+
+// Returns an HTML form for |signon_realm|, distinguished by |username|.
+PasswordForm CreateForm(const std::string& signon_realm, int username) {
+  PasswordForm form;
+  form.origin = GURL(signon_realm + "login");
+  form.action = GURL(signon_realm + "submit");
+  form.username_element = ASCIIToUTF16("username");
+  form.username_value = ASCIIToUTF16(base::StringPrintf("user%d", username));
+  form.password_element = ASCIIToUTF16("password");
+  form.password_value = ASCIIToUTF16("hunter2");
+  form.signon_realm = signon_realm;
+  form.scheme = PasswordForm::SCHEME_HTML;
+  return form;
+}
+
+class LoginDatabasePerfTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    ASSERT_TRUE(db_.Init(temp_dir_.path().AppendASCII("TestMetadataStoreDB")));
+
+    // Ten logins on each of kNumLogins / 10 sites, split between the desktop
+    // and mobile subdomains so that lookups hit both exact and PSL matches.
+    for (int i = 0; i < kNumLogins; ++i) {
+      std::string realm = base::StringPrintf(
+          "https://%s.site%d.com/", i % 2 ? "www" : "m", i / 10);
+      ASSERT_FALSE(db_.AddLogin(CreateForm(realm, i)).empty());
+    }
+  }
+
+  base::ScopedTempDir temp_dir_;
+  LoginDatabase db_;
+};
+
+}  // namespace
+
+TEST_F(LoginDatabasePerfTest, GetLogins) {
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kNumLookups; ++i) {
+    PasswordForm observed = CreateForm(
+        base::StringPrintf("https://www.site%d.com/", i % (kNumLogins / 10)),
+        0);
+    ScopedVector<PasswordForm> result;
+    ASSERT_TRUE(db_.GetLogins(observed, &result.get()));
+    ASSERT_EQ(10U, result.size());
+  }
+  base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+
+  perf_test::PrintResult("login_database_get_logins", "", "10k_logins",
+                         elapsed.InMillisecondsF() * 1000 / kNumLookups,
+                         "us/lookup", true);
+}
+
+}  // namespace password_manager
@@ -415,9 +415,8 @@ TEST_F(LoginDatabaseTest, TestPublicSuffixDomainMatchingShouldMatchingApply) {
   EXPECT_EQ(0U, result.size());
 }
 
-// This test fails if the implementation of GetLogins uses GetCachedStatement
-// instead of GetUniqueStatement, since REGEXP is in use. See
-// http://crbug.com/248608.
+// This test used to fail when GetLogins matched realms with REGEXP through a
+// cached statement. See http://crbug.com/248608.
 TEST_F(LoginDatabaseTest, TestPublicSuffixDomainMatchingDifferentSites) {
   std::vector<PasswordForm*> result;
 
@@ -632,6 +631,50 @@ TEST_F(LoginDatabaseTest, TestPublicSuffixDomainMatchingRegexp) {
   EXPECT_EQ(0U, result.size());
 }
 
+// Checks that logins added or removed after the first PSL lookup are seen by
+// the following ones.
+TEST_F(LoginDatabaseTest, TestPublicSuffixDomainMatchingAfterChanges) {
+  ScopedVector<PasswordForm> result;
+
+  PasswordForm form;
+  form.origin = GURL("https://foo.com/");
+  form.action = GURL("https://foo.com/login");
+  form.username_element = ASCIIToUTF16("username");
+  form.username_value = ASCIIToUTF16("test@gmail.com");
+  form.password_element = ASCIIToUTF16("password");
+  form.password_value = ASCIIToUTF16("test");
+  form.signon_realm = "https://foo.com/";
+  form.scheme = PasswordForm::SCHEME_HTML;
+  EXPECT_EQ(AddChangeForForm(form), db_.AddLogin(form));
+
+  PasswordForm mobile_form = GetFormWithNewSignonRealm(form,
+                                                       "https://m.foo.com/");
+  EXPECT_TRUE(db_.GetLogins(mobile_form, &result.get()));
+  ASSERT_EQ(1U, result.size());
+  EXPECT_EQ("https://foo.com/", result[0]->original_signon_realm);
+  result.clear();
+
+  // A login for another subdomain, added after the first lookup.
+  PasswordForm www_form = GetFormWithNewSignonRealm(form,
+                                                    "https://www.foo.com/");
+  EXPECT_EQ(AddChangeForForm(www_form), db_.AddLogin(www_form));
+  EXPECT_TRUE(db_.GetLogins(mobile_form, &result.get()));
+  EXPECT_EQ(2U, result.size());
+  result.clear();
+
+  // Removed logins are no longer returned.
+  EXPECT_TRUE(db_.RemoveLogin(form));
+  EXPECT_TRUE(db_.GetLogins(mobile_form, &result.get()));
+  ASSERT_EQ(1U, result.size());
+  EXPECT_EQ("https://www.foo.com/", result[0]->original_signon_realm);
+  result.clear();
+
+  // The exact match is still found alongside PSL matches.
+  EXPECT_TRUE(db_.GetLogins(www_form, &result.get()));
+  ASSERT_EQ(1U, result.size());
+  EXPECT_TRUE(result[0]->original_signon_realm.empty());
+}
+
 static bool AddTimestampedLogin(LoginDatabase* db,
                                 std::string url,
                                 const std::string& unique_string,
@@ -26,7 +26,7 @@ ContentSerializedNavigationBuilder::FromNavigationEntry(
   navigation.referrer_policy_ = entry.GetReferrer().policy;
   navigation.virtual_url_ = entry.GetVirtualURL();
   navigation.title_ = entry.GetTitle();
-  navigation.encoded_page_state_ = entry.GetPageState().ToEncodedData();
+  navigation.SetEncodedPageState(entry.GetPageState().ToEncodedData());
   navigation.transition_type_ = entry.GetTransitionType();
   navigation.has_post_data_ = entry.GetHasPostData();
   navigation.post_id_ = entry.GetPostID();
@@ -68,7 +68,7 @@ ContentSerializedNavigationBuilder::ToNavigationEntry(
 
   entry->SetTitle(navigation->title_);
   entry->SetPageState(content::PageState::CreateFromEncodedData(
-      navigation->encoded_page_state_));
+      navigation->encoded_page_state()));
   entry->SetPageID(page_id);
   entry->SetHasPostData(navigation->has_post_data_);
   entry->SetPostID(navigation->post_id_);
@@ -83,11 +83,11 @@ std::string
 ContentSerializedNavigationDriver::GetSanitizedPageStateForPickle(
     const SerializedNavigationEntry* navigation) const {
   if (!navigation->has_post_data_) {
-    return navigation->encoded_page_state_;
+    return navigation->encoded_page_state();
   }
   content::PageState page_state =
       content::PageState::CreateFromEncodedData(
-          navigation->encoded_page_state_);
+          navigation->encoded_page_state());
   return page_state.RemovePasswordData().ToEncodedData();
 }
 
@@ -106,8 +106,8 @@ void ContentSerializedNavigationDriver::Sanitize(
   if (navigation->referrer_url_ != new_referrer.url) {
     navigation->referrer_url_ = GURL();
     navigation->referrer_policy_ = GetDefaultReferrerPolicy();
-    navigation->encoded_page_state_ =
-        StripReferrerFromPageState(navigation->encoded_page_state_);
+    navigation->SetEncodedPageState(
+        StripReferrerFromPageState(navigation->encoded_page_state()));
   }
 }
 
@@ -5,6 +5,7 @@
 #include "components/sessions/serialized_navigation_entry.h"
 
 #include "base/pickle.h"
+#include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
 #include "components/sessions/core/serialized_navigation_driver.h"
 #include "sync/protocol/session_specifics.pb.h"
@@ -30,13 +31,33 @@ SerializedNavigationEntry::SerializedNavigationEntry()
 
 SerializedNavigationEntry::~SerializedNavigationEntry() {}
 
+const std::string& SerializedNavigationEntry::encoded_page_state() const {
+  return encoded_page_state_.get() ? encoded_page_state_->data()
+                                   : base::EmptyString();
+}
+
+void SerializedNavigationEntry::SetEncodedPageState(
+    const std::string& encoded_page_state) {
+  if (encoded_page_state.empty()) {
+    encoded_page_state_ = NULL;
+    return;
+  }
+  // Keep sharing the current buffer when the state is unchanged, e.g. when
+  // stripping the referrer left it as it was.
+  if (encoded_page_state_.get() &&
+      encoded_page_state_->data() == encoded_page_state)
+    return;
+  encoded_page_state_ = new base::RefCountedString;
+  encoded_page_state_->data() = encoded_page_state;
+}
+
 SerializedNavigationEntry SerializedNavigationEntry::FromSyncData(
     int index,
     const sync_pb::TabNavigation& sync_data) {
   SerializedNavigationEntry navigation;
   navigation.index_ = index;
   navigation.unique_id_ = sync_data.unique_id();
-  navigation.encoded_page_state_ = sync_data.state();
+  navigation.SetEncodedPageState(sync_data.state());
   if (sync_data.has_correct_referrer_policy()) {
     navigation.referrer_url_ = GURL(sync_data.referrer());
     navigation.referrer_policy_ = sync_data.correct_referrer_policy();
@@ -49,9 +70,9 @@ SerializedNavigationEntry SerializedNavigationEntry::FromSyncData(
       navigation.referrer_url_ = GURL();
     }
     navigation.referrer_policy_ = mapped_referrer_policy;
-    navigation.encoded_page_state_ =
+    navigation.SetEncodedPageState(
         SerializedNavigationDriver::Get()->StripReferrerFromPageState(
-            navigation.encoded_page_state_);
+            navigation.encoded_page_state()));
   }
   navigation.virtual_url_ = GURL(sync_data.virtual_url());
   navigation.title_ = base::UTF8ToUTF16(sync_data.title());
@@ -253,14 +274,19 @@ void SerializedNavigationEntry::WriteToPickle(int max_size,
 bool SerializedNavigationEntry::ReadFromPickle(PickleIterator* iterator) {
   *this = SerializedNavigationEntry();
   std::string virtual_url_spec;
+  std::string encoded_page_state;
   int transition_type_int = 0;
   if (!iterator->ReadInt(&index_) ||
       !iterator->ReadString(&virtual_url_spec) ||
       !iterator->ReadString16(&title_) ||
-      !iterator->ReadString(&encoded_page_state_) ||
+      !iterator->ReadString(&encoded_page_state) ||
       !iterator->ReadInt(&transition_type_int))
     return false;
   virtual_url_ = GURL(virtual_url_spec);
+  if (!encoded_page_state.empty()) {
+    encoded_page_state_ =
+        base::RefCountedString::TakeString(&encoded_page_state);
+  }
   transition_type_ = ui::PageTransitionFromInt(transition_type_int);
 
   // type_mask did not always exist in the written stream. As such, we
@@ -322,9 +348,9 @@ bool SerializedNavigationEntry::ReadFromPickle(PickleIterator* iterator) {
         referrer_url_ = GURL();
       }
       referrer_policy_ = mapped_referrer_policy;
-      encoded_page_state_ =
+      SetEncodedPageState(
           SerializedNavigationDriver::Get()->StripReferrerFromPageState(
-              encoded_page_state_);
+              encoded_page_state()));
     }
   }
 
@@ -10,6 +10,8 @@
 #include <vector>
 
 #include "base/basictypes.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/ref_counted_memory.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/strings/string16.h"
 #include "base/time/time.h"
@@ -36,7 +38,8 @@ SESSIONS_EXPORT extern const char kSearchTermsKey[];
 // and tab restore, and it can also be pickled and unpickled.  It is also
 // convertible to a sync protocol buffer for session syncing.
 //
-// Default copy constructor and assignment operator welcome.
+// Default copy constructor and assignment operator welcome. Copies share the
+// encoded page state, which is immutable once set, rather than duplicating it.
 class SESSIONS_EXPORT SerializedNavigationEntry {
  public:
   enum BlockedState {
@@ -77,7 +80,7 @@ class SESSIONS_EXPORT SerializedNavigationEntry {
   int unique_id() const { return unique_id_; }
   const GURL& virtual_url() const { return virtual_url_; }
   const base::string16& title() const { return title_; }
-  const std::string& encoded_page_state() const { return encoded_page_state_; }
+  const std::string& encoded_page_state() const;
   const base::string16& search_terms() const { return search_terms_; }
   const GURL& favicon_url() const { return favicon_url_; }
   int http_status_code() const { return http_status_code_; }
@@ -112,6 +115,10 @@ class SESSIONS_EXPORT SerializedNavigationEntry {
   friend class IOSSerializedNavigationBuilder;
   friend class IOSSerializedNavigationDriver;
 
+  // Replaces the encoded page state. Entries copied from this one keep the
+  // previous state.
+  void SetEncodedPageState(const std::string& encoded_page_state);
+
   // Index in the NavigationController.
   int index_;
 
@@ -121,7 +128,10 @@ class SESSIONS_EXPORT SerializedNavigationEntry {
   int referrer_policy_;
   GURL virtual_url_;
   base::string16 title_;
-  std::string encoded_page_state_;
+  // The encoded PageState, shared between copies of this entry. PageState
+  // blobs hold form data and scroll offsets for every frame and are by far
+  // the largest part of an entry. NULL when there is no state.
+  scoped_refptr<base::RefCountedString> encoded_page_state_;
   ui::PageTransition transition_type_;
   bool has_post_data_;
   int64 post_id_;
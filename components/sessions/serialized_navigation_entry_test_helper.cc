@@ -50,7 +50,7 @@ void SerializedNavigationEntryTestHelper::ExpectNavigationEquals(
   EXPECT_EQ(expected.referrer_policy_, actual.referrer_policy_);
   EXPECT_EQ(expected.virtual_url_, actual.virtual_url_);
   EXPECT_EQ(expected.title_, actual.title_);
-  EXPECT_EQ(expected.encoded_page_state_, actual.encoded_page_state_);
+  EXPECT_EQ(expected.encoded_page_state(), actual.encoded_page_state());
   EXPECT_EQ(expected.transition_type_, actual.transition_type_);
   EXPECT_EQ(expected.has_post_data_, actual.has_post_data_);
   EXPECT_EQ(expected.original_request_url_, actual.original_request_url_);
@@ -67,7 +67,7 @@ SerializedNavigationEntry SerializedNavigationEntryTestHelper::CreateNavigation(
   navigation.referrer_url_ = GURL("http://www.referrer.com");
   navigation.virtual_url_ = GURL(virtual_url);
   navigation.title_ = base::UTF8ToUTF16(title);
-  navigation.encoded_page_state_ = "fake state";
+  navigation.SetEncodedPageState("fake state");
   navigation.timestamp_ = base::Time::Now();
   navigation.http_status_code_ = 200;
   return navigation;
@@ -83,7 +83,7 @@ SerializedNavigationEntryTestHelper::CreateNavigationForTest() {
   navigation.referrer_policy_ = test_data::kReferrerPolicy;
   navigation.virtual_url_ = test_data::kVirtualURL;
   navigation.title_ = test_data::kTitle;
-  navigation.encoded_page_state_ = test_data::kEncodedPageState;
+  navigation.SetEncodedPageState(test_data::kEncodedPageState);
   navigation.transition_type_ = test_data::kTransitionType;
   navigation.has_post_data_ = test_data::kHasPostData;
   navigation.post_id_ = test_data::kPostID;
@@ -118,7 +118,7 @@ void SerializedNavigationEntryTestHelper::SetVirtualURL(
 void SerializedNavigationEntryTestHelper::SetEncodedPageState(
     const std::string& encoded_page_state,
     SerializedNavigationEntry* navigation) {
-  navigation->encoded_page_state_ = encoded_page_state;
+  navigation->SetEncodedPageState(encoded_page_state);
 }
 
 // static
@@ -137,6 +137,25 @@ TEST(SerializedNavigationEntryTest, Pickle) {
   EXPECT_EQ(0U, new_navigation.redirect_chain().size());
 }
 
+// Copies of a SerializedNavigationEntry should share its encoded page state,
+// and changing the state of one copy should leave the others alone.
+TEST(SerializedNavigationEntryTest, CopiesSharePageState) {
+  const SerializedNavigationEntry navigation =
+      SerializedNavigationEntryTestHelper::CreateNavigationForTest();
+  SerializedNavigationEntry copy = navigation;
+  EXPECT_EQ(test_data::kEncodedPageState, copy.encoded_page_state());
+  EXPECT_EQ(navigation.encoded_page_state().data(),
+            copy.encoded_page_state().data());
+
+  SerializedNavigationEntryTestHelper::SetEncodedPageState("new state", &copy);
+  EXPECT_EQ("new state", copy.encoded_page_state());
+  EXPECT_EQ(test_data::kEncodedPageState, navigation.encoded_page_state());
+
+  SerializedNavigationEntryTestHelper::SetEncodedPageState(std::string(),
+                                                           &copy);
+  EXPECT_EQ(std::string(), copy.encoded_page_state());
+}
+
 // Create a SerializedNavigationEntry, then create a sync protocol buffer from
 // it.  The protocol buffer should have matching fields to the
 // SerializedNavigationEntry (when applicable).
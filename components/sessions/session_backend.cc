@@ -198,7 +198,7 @@ static const char* kCurrentSessionFileName = "Current Session";
 static const char* kLastSessionFileName = "Last Session";
 
 // static
-const int SessionBackend::kFileReadBufferSize = 1024;
+const int SessionBackend::kFileReadBufferSize = 32 * 1024;
 
 SessionBackend::SessionBackend(sessions::BaseSessionService::SessionType type,
                                const base::FilePath& path_to_dir)
@@ -36,8 +36,9 @@ class SessionBackend : public base::RefCountedThreadSafe<SessionBackend> {
   typedef sessions::SessionCommand::id_type id_type;
   typedef sessions::SessionCommand::size_type size_type;
 
-  // Initial size of the buffer used in reading the file. This is exposed
-  // for testing.
+  // Initial size of the buffer used in reading the file. Session files with
+  // many tabs are several megabytes, so this is large enough to avoid a read
+  // per command. This is exposed for testing.
   static const int kFileReadBufferSize;
 
   // Creates a SessionBackend. This method is invoked on the MAIN thread,
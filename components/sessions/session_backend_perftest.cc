@@ -0,0 +1,121 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+#include <vector>
+
+#include "base/files/scoped_temp_dir.h"
+#include "base/memory/scoped_vector.h"
+#include "base/stl_util.h"
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
+#include "components/sessions/serialized_navigation_entry_test_helper.h"
+#include "components/sessions/session_backend.h"
+#include "components/sessions/session_command.h"
+#include "components/sessions/session_service_commands.h"
+#include "components/sessions/session_types.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+#include "ui/gfx/geometry/rect.h"
+
+namespace sessions {
+
+namespace {
+
+const int kNumTabs = 500;
+
+// Appends the commands SessionService writes for a single window holding
+// |num_tabs| tabs, each with |num_navigations| history entries. Every entry
+// is updated twice, as happens when a page's title arrives after it commits.
+void BuildSessionCommands(int num_tabs,
+                          int num_navigations,
+                          ScopedVector<SessionCommand>* commands) {
+  SessionID window_id;
+  commands->push_back(CreateSetWindowBoundsCommand(
+      window_id, gfx::Rect(0, 0, 800, 600), ui::SHOW_STATE_NORMAL).release());
+  commands->push_back(CreateSetWindowTypeCommand(
+      window_id, SessionWindow::TYPE_TABBED).release());
+
+  for (int tab = 0; tab < num_tabs; ++tab) {
+    SessionID tab_id;
+    commands->push_back(
+        CreateSetTabWindowCommand(window_id, tab_id).release());
+    commands->push_back(
+        CreateSetTabIndexInWindowCommand(tab_id, tab).release());
+    for (int pass = 0; pass < 2; ++pass) {
+      for (int nav = 0; nav < num_navigations; ++nav) {
+        SerializedNavigationEntry navigation =
+            SerializedNavigationEntryTestHelper::CreateNavigation(
+                base::StringPrintf("http://www.example.com/%d/%d", tab, nav),
+                "title");
+        navigation.set_index(nav);
+        commands->push_back(
+            CreateUpdateTabNavigationCommand(tab_id, navigation).release());
+      }
+    }
+    commands->push_back(CreateSetSelectedNavigationIndexCommand(
+        tab_id, num_navigations - 1).release());
+  }
+  commands->push_back(CreateSetActiveWindowCommand(window_id).release());
+}
+
+class SessionBackendPerfTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+  }
+
+  // Writes a session with kNumTabs tabs of |num_navigations| entries each,
+  // then reports the time taken to read it back and rebuild the windows.
+  void RunRestore(int num_navigations) {
+    scoped_refptr<SessionBackend> backend(new SessionBackend(
+        BaseSessionService::SESSION_RESTORE, temp_dir_.path()));
+    ScopedVector<SessionCommand> commands;
+    BuildSessionCommands(kNumTabs, num_navigations, &commands);
+    backend->AppendCommands(commands.Pass(), true);
+
+    // A new backend moves the file just written to the last session, as
+    // happens at startup.
+    backend = new SessionBackend(BaseSessionService::SESSION_RESTORE,
+                                 temp_dir_.path());
+
+    base::TimeTicks start = base::TimeTicks::Now();
+    ScopedVector<SessionCommand> read_commands;
+    ASSERT_TRUE(backend->ReadLastSessionCommandsImpl(&read_commands));
+    base::TimeTicks read_done = base::TimeTicks::Now();
+
+    std::vector<SessionWindow*> windows;
+    SessionID::id_type active_window_id = 0;
+    RestoreSessionFromCommands(read_commands, &windows, &active_window_id);
+    base::TimeTicks restore_done = base::TimeTicks::Now();
+
+    ASSERT_EQ(1U, windows.size());
+    ASSERT_EQ(static_cast<size_t>(kNumTabs), windows[0]->tabs.size());
+    EXPECT_EQ(static_cast<size_t>(num_navigations),
+              windows[0]->tabs[0]->navigations.size());
+    STLDeleteElements(&windows);
+
+    std::string modifier = base::StringPrintf("_%d_navigations",
+                                              num_navigations);
+    perf_test::PrintResult("session_restore_read", modifier, "500_tabs",
+                           (read_done - start).InMillisecondsF(), "ms", true);
+    perf_test::PrintResult("session_restore_rebuild", modifier, "500_tabs",
+                           (restore_done - read_done).InMillisecondsF(), "ms",
+                           true);
+  }
+
+  base::ScopedTempDir temp_dir_;
+};
+
+}  // namespace
+
+TEST_F(SessionBackendPerfTest, ShallowHistories) {
+  RunRestore(5);
+}
+
+TEST_F(SessionBackendPerfTest, DeepHistories) {
+  RunRestore(50);
+}
+
+}  // namespace sessions
@@ -4,6 +4,7 @@
 
 #include "components/sessions/session_service_commands.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "base/pickle.h"
@@ -199,22 +200,25 @@ SessionTab* GetTab(SessionID::id_type tab_id, IdToSessionTab* tabs) {
   return i->second;
 }
 
+// Compares a navigation's index with |index|, for use with std::lower_bound.
+bool NavigationIndexLessThan(const sessions::SerializedNavigationEntry& entry,
+                             int index) {
+  return entry.index() < index;
+}
+
 // Returns an iterator into navigations pointing to the navigation whose
 // index matches |index|. If no navigation index matches |index|, the first
 // navigation with an index > |index| is returned.
 //
-// This assumes the navigations are ordered by index in ascending order.
+// This assumes the navigations are ordered by index in ascending order, which
+// lets restoring tabs with deep histories avoid a linear scan per command.
 std::vector<sessions::SerializedNavigationEntry>::iterator
   FindClosestNavigationWithIndex(
     std::vector<sessions::SerializedNavigationEntry>* navigations,
     int index) {
   DCHECK(navigations);
-  for (std::vector<sessions::SerializedNavigationEntry>::iterator
-           i = navigations->begin(); i != navigations->end(); ++i) {
-    if (i->index() >= index)
-      return i;
-  }
-  return navigations->end();
+  return std::lower_bound(navigations->begin(), navigations->end(), index,
+                          &NavigationIndexLessThan);
 }
 
 // Function used in sorting windows. Sorting is done based on window id. As
@@ -37,6 +37,15 @@ class CONTENT_EXPORT DownloadResourceHandler
   // downstream receiver of its output.
   static const int kDownloadByteStreamSize;
 
+  // Returns the size of the buffer for the next read, adapted to the rate data
+  // arrives at. |read_buffer_size| is the current size, and the last read put
+  // |bytes_read| bytes into a buffer of |last_buffer_size| bytes, leaving the
+  // stream full if |stream_full|.
+  static int GetNextReadBufferSize(int read_buffer_size,
+                                   size_t last_buffer_size,
+                                   int bytes_read,
+                                   bool stream_full);
+
   // started_cb will be called exactly once on the UI thread.
   // |id| should be invalid if the id should be automatically assigned.
   DownloadResourceHandler(
@@ -106,6 +115,7 @@ class CONTENT_EXPORT DownloadResourceHandler
 
   // Data flow
   scoped_refptr<net::IOBuffer> read_buffer_;       // From URLRequest.
+  int read_buffer_size_;  // Size of the next |read_buffer_|, adapted to rate.
   scoped_ptr<ByteStreamWriter> stream_writer_; // To rest of system.
 
   // Keeps the system from sleeping while this ResourceHandler is alive. If the
@@ -128,6 +138,7 @@ class CONTENT_EXPORT DownloadResourceHandler
   bool on_response_started_called_;
 
   static const int kReadBufSize = 32768;  // bytes
+  static const int kMaxReadBufSize = 65536;  // bytes
   static const int kThrottleTimeMs = 200;  // milliseconds
 
   DISALLOW_COPY_AND_ASSIGN(DownloadResourceHandler);
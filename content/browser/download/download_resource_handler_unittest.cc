@@ -0,0 +1,66 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/download/download_resource_handler.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace content {
+
+namespace {
+
+const int kInitialReadSize = 32768;
+
+int GetNextReadBufferSize(int size, int bytes_read, bool stream_full) {
+  return DownloadResourceHandler::GetNextReadBufferSize(
+      size, size, bytes_read, stream_full);
+}
+
+}  // namespace
+
+TEST(DownloadResourceHandlerTest, ReadBufferGrowsWithFullReads) {
+  int size = GetNextReadBufferSize(kInitialReadSize, kInitialReadSize, false);
+  EXPECT_EQ(2 * kInitialReadSize, size);
+
+  // Growth stops at a maximum size.
+  int max_size = size;
+  for (int i = 0; i < 10; ++i)
+    max_size = GetNextReadBufferSize(max_size, max_size, false);
+  EXPECT_EQ(max_size, GetNextReadBufferSize(max_size, max_size, false));
+
+  // It doesn't grow while the stream is full, nor when a read is only
+  // partially full.
+  EXPECT_EQ(kInitialReadSize,
+            GetNextReadBufferSize(kInitialReadSize, kInitialReadSize, true));
+  EXPECT_EQ(kInitialReadSize,
+            GetNextReadBufferSize(kInitialReadSize, kInitialReadSize / 2,
+                                  false));
+
+  // A read the caller asked to be larger than the current size doesn't grow
+  // it either, unless that read is full.
+  EXPECT_EQ(kInitialReadSize,
+            DownloadResourceHandler::GetNextReadBufferSize(
+                kInitialReadSize, 4 * kInitialReadSize, kInitialReadSize,
+                false));
+}
+
+TEST(DownloadResourceHandlerTest, ReadBufferShrinksWithSparseReads) {
+  int max_size = kInitialReadSize;
+  for (int i = 0; i < 10; ++i)
+    max_size = GetNextReadBufferSize(max_size, max_size, false);
+
+  // Reads under a quarter full halve the size, whether or not the stream is
+  // full, down to the initial size.
+  EXPECT_EQ(max_size / 2, GetNextReadBufferSize(max_size, 100, false));
+  EXPECT_EQ(max_size / 2, GetNextReadBufferSize(max_size, 100, true));
+  int size = max_size;
+  for (int i = 0; i < 10; ++i)
+    size = GetNextReadBufferSize(size, 100, false);
+  EXPECT_EQ(kInitialReadSize, size);
+
+  // A read at least a quarter full keeps the size.
+  EXPECT_EQ(max_size, GetNextReadBufferSize(max_size, max_size / 4, false));
+}
+
+}  // namespace content
@@ -6,6 +6,7 @@
 #define CONTENT_BROWSER_RENDERER_HOST_INPUT_INPUT_ROUTER_H_
 
 #include "base/basictypes.h"
+#include "base/time/time.h"
 #include "content/browser/renderer_host/event_with_latency_info.h"
 #include "content/common/input/input_event_ack_state.h"
 #include "content/public/browser/native_web_keyboard_event.h"
@@ -64,6 +65,11 @@ class InputRouter : public IPC::Listener {
   };
   virtual void OnViewUpdated(int view_flags) = 0;
 
+  // Tells the router when the display refreshes, so that it can align the
+  // dispatch of coalesced input with frames.
+  virtual void OnVSyncParametersChanged(base::TimeTicks timebase,
+                                        base::TimeDelta interval) = 0;
+
   virtual bool HasPendingEvents() const = 0;
 };
 
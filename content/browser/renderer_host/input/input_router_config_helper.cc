@@ -117,6 +117,8 @@ InputRouterImpl::Config GetInputRouterConfigForPlatform() {
   config.gesture_config = GetGestureEventQueueConfig();
   config.touch_config = GetTouchEventQueueConfig();
   config.touch_config.touch_scrolling_mode = GetTouchScrollingMode();
+  config.batch_mouse_moves = base::CommandLine::ForCurrentProcess()->HasSwitch(
+      switches::kEnableInputEventBatching);
   return config;
 }
 
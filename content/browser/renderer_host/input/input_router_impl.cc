@@ -6,6 +6,8 @@
 
 #include <math.h>
 
+#include <algorithm>
+
 #include "base/auto_reset.h"
 #include "base/command_line.h"
 #include "base/metrics/histogram.h"
@@ -55,9 +57,12 @@ const char* GetEventAckName(InputEventAckState ack_result) {
   return "";
 }
 
+// Used until the view reports the display's actual vsync interval.
+const int64 kDefaultVSyncIntervalUs = base::Time::kMicrosecondsPerSecond / 60;
+
 } // namespace
 
-InputRouterImpl::Config::Config() {
+InputRouterImpl::Config::Config() : batch_mouse_moves(false) {
 }
 
 InputRouterImpl::InputRouterImpl(IPC::Sender* sender,
@@ -72,6 +77,9 @@ InputRouterImpl::InputRouterImpl(IPC::Sender* sender,
       select_message_pending_(false),
       move_caret_pending_(false),
       mouse_move_pending_(false),
+      batch_mouse_moves_(config.batch_mouse_moves),
+      vsync_interval_(
+          base::TimeDelta::FromMicroseconds(kDefaultVSyncIntervalUs)),
       mouse_wheel_pending_(false),
       current_view_flags_(0),
       current_ack_source_(ACK_SOURCE_NONE),
@@ -206,14 +214,17 @@ void InputRouterImpl::SendMouseEventImmediately(
   // thread is able to rapidly consume WM_MOUSEMOVE events, we may get way
   // more WM_MOUSEMOVE events than we wish to send to the renderer.
   if (mouse_event.event.type == WebInputEvent::MouseMove) {
-    if (mouse_move_pending_) {
+    if (mouse_move_pending_ || ShouldBatchMouseMove()) {
       if (!next_mouse_move_)
         next_mouse_move_.reset(new MouseEventWithLatencyInfo(mouse_event));
       else
         next_mouse_move_->CoalesceWith(mouse_event);
+      if (!mouse_move_pending_)
+        StartMouseMoveBatchTimer();
       return;
     }
     mouse_move_pending_ = true;
+    last_mouse_move_time_ = TimeTicks::Now();
   }
 
   FilterAndSendWebInputEvent(mouse_event.event, mouse_event.latency, false);
@@ -263,6 +274,14 @@ void InputRouterImpl::OnViewUpdated(int view_flags) {
   UpdateTouchAckTimeoutEnabled();
 }
 
+void InputRouterImpl::OnVSyncParametersChanged(base::TimeTicks timebase,
+                                               base::TimeDelta interval) {
+  if (interval <= base::TimeDelta())
+    return;
+  vsync_timebase_ = timebase;
+  vsync_interval_ = interval;
+}
+
 bool InputRouterImpl::OnMessageReceived(const IPC::Message& message) {
   bool handled = true;
   IPC_BEGIN_MESSAGE_MAP(InputRouterImpl, message)
@@ -608,12 +627,48 @@ void InputRouterImpl::ProcessMouseAck(blink::WebInputEvent::Type type,
 
   if (next_mouse_move_) {
     DCHECK(next_mouse_move_->event.type == WebInputEvent::MouseMove);
+    if (ShouldBatchMouseMove()) {
+      StartMouseMoveBatchTimer();
+      return;
+    }
     scoped_ptr<MouseEventWithLatencyInfo> next_mouse_move
         = next_mouse_move_.Pass();
     SendMouseEvent(*next_mouse_move);
   }
 }
 
+TimeTicks InputRouterImpl::GetNextVSyncTime(TimeTicks time) const {
+  TimeDelta since_timebase = time - vsync_timebase_;
+  if (since_timebase < TimeDelta())
+    return vsync_timebase_;
+  int64 intervals = since_timebase / vsync_interval_;
+  return vsync_timebase_ + vsync_interval_ * (intervals + 1);
+}
+
+bool InputRouterImpl::ShouldBatchMouseMove() const {
+  if (!batch_mouse_moves_ || last_mouse_move_time_.is_null())
+    return false;
+  return GetNextVSyncTime(last_mouse_move_time_) > TimeTicks::Now();
+}
+
+void InputRouterImpl::StartMouseMoveBatchTimer() {
+  if (mouse_move_batch_timer_.IsRunning())
+    return;
+  TimeDelta delay =
+      GetNextVSyncTime(last_mouse_move_time_) - TimeTicks::Now();
+  mouse_move_batch_timer_.Start(
+      FROM_HERE, std::max(delay, TimeDelta()), this,
+      &InputRouterImpl::FlushBatchedMouseMove);
+}
+
+void InputRouterImpl::FlushBatchedMouseMove() {
+  if (mouse_move_pending_ || !next_mouse_move_)
+    return;
+  scoped_ptr<MouseEventWithLatencyInfo> next_mouse_move =
+      next_mouse_move_.Pass();
+  SendMouseEvent(*next_mouse_move);
+}
+
 void InputRouterImpl::ProcessWheelAck(InputEventAckState ack_result,
                                       const ui::LatencyInfo& latency) {
   // TODO(miletus): Add renderer side latency to each uncoalesced mouse
@@ -694,6 +749,7 @@ bool InputRouterImpl::HasPendingEvents() const {
          !gesture_event_queue_.empty() ||
          !key_queue_.empty() ||
          mouse_move_pending_ ||
+         next_mouse_move_ ||
          mouse_wheel_pending_ ||
          select_message_pending_ ||
          move_caret_pending_;
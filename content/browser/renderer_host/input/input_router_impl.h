@@ -10,6 +10,7 @@
 #include "base/basictypes.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/time/time.h"
+#include "base/timer/timer.h"
 #include "content/browser/renderer_host/input/gesture_event_queue.h"
 #include "content/browser/renderer_host/input/input_router.h"
 #include "content/browser/renderer_host/input/touch_action_filter.h"
@@ -46,6 +47,11 @@ class CONTENT_EXPORT InputRouterImpl
     Config();
     GestureEventQueue::Config gesture_config;
     TouchEventQueue::Config touch_config;
+
+    // Whether to forward at most one mouse move per vsync interval, even if
+    // the renderer acks faster than that. Moves arriving in between are
+    // coalesced and sent at the next vsync. Defaults to false.
+    bool batch_mouse_moves;
   };
 
   InputRouterImpl(IPC::Sender* sender,
@@ -70,6 +76,8 @@ class CONTENT_EXPORT InputRouterImpl
   const NativeWebKeyboardEvent* GetLastKeyboardEvent() const override;
   bool ShouldForwardTouchEvent() const override;
   void OnViewUpdated(int view_flags) override;
+  void OnVSyncParametersChanged(base::TimeTicks timebase,
+                                base::TimeDelta interval) override;
   bool HasPendingEvents() const override;
 
   // IPC::Listener
@@ -175,6 +183,20 @@ private:
   void ProcessMouseAck(blink::WebInputEvent::Type type,
                        InputEventAckState ack_result);
 
+  // Returns the first vsync tick after |time|.
+  base::TimeTicks GetNextVSyncTime(base::TimeTicks time) const;
+
+  // Returns true if a mouse move has already been forwarded in the current
+  // vsync interval, so that the next one should wait for the next interval.
+  bool ShouldBatchMouseMove() const;
+
+  // Arms |mouse_move_batch_timer_| to fire at the next vsync.
+  void StartMouseMoveBatchTimer();
+
+  // Forwards |next_mouse_move_| unless a mouse move ack is outstanding, in
+  // which case the ack will forward it.
+  void FlushBatchedMouseMove();
+
   // Dispatches the ack'ed event to |ack_handler_|, forwarding queued events
   // from |coalesced_mouse_wheel_events_|.
   void ProcessWheelAck(InputEventAckState ack_result,
@@ -231,9 +253,22 @@ private:
   bool mouse_move_pending_;
 
   // The next mouse move event to send (only non-null while mouse_move_pending_
-  // is true).
+  // is true, or while it is being held by mouse move batching).
   scoped_ptr<MouseEventWithLatencyInfo> next_mouse_move_;
 
+  // See |Config::batch_mouse_moves|.
+  bool batch_mouse_moves_;
+
+  // The time the last mouse move was forwarded to the renderer.
+  base::TimeTicks last_mouse_move_time_;
+
+  // Forwards a batched |next_mouse_move_| at the next vsync.
+  base::OneShotTimer<InputRouterImpl> mouse_move_batch_timer_;
+
+  // The display's vsync phase and interval, from |OnVSyncParametersChanged()|.
+  base::TimeTicks vsync_timebase_;
+  base::TimeDelta vsync_interval_;
+
   // (Similar to |mouse_move_pending_|.) True if a mouse wheel event was sent
   // and we are waiting for a corresponding ack.
   bool mouse_wheel_pending_;
@@ -4,20 +4,24 @@
 
 #include "base/basictypes.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/run_loop.h"
 #include "content/browser/renderer_host/input/input_ack_handler.h"
 #include "content/browser/renderer_host/input/input_router_client.h"
 #include "content/browser/renderer_host/input/input_router_impl.h"
+#include "content/common/input/synthetic_web_input_event_builders.h"
 #include "content/common/input/web_input_event_traits.h"
 #include "content/common/input_messages.h"
 #include "content/common/view_messages.h"
 #include "ipc/ipc_sender.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "testing/perf/perf_test.h"
+#include "ui/events/latency_info.h"
 #include "ui/gfx/geometry/vector2d_f.h"
 
 using base::TimeDelta;
 using blink::WebGestureEvent;
 using blink::WebInputEvent;
+using blink::WebMouseEvent;
 using blink::WebTouchEvent;
 using blink::WebTouchPoint;
 
@@ -25,6 +29,8 @@ namespace content {
 
 namespace {
 
+const int64 kLatencyComponentId = 1;
+
 class NullInputAckHandler : public InputAckHandler {
  public:
   NullInputAckHandler() : ack_count_(0) {}
@@ -88,6 +94,16 @@ class NullIPCSender : public IPC::Sender {
   ~NullIPCSender() override {}
 
   bool Send(IPC::Message* message) override {
+    // Accumulate how long each forwarded event has waited since it entered
+    // the router, according to its (oldest, if coalesced) LatencyInfo.
+    InputMsg_HandleInputEvent::Param params;
+    ui::LatencyInfo::LatencyComponent component;
+    if (message->type() == InputMsg_HandleInputEvent::ID &&
+        InputMsg_HandleInputEvent::Read(message, &params) &&
+        get<1>(params).FindLatency(ui::INPUT_EVENT_LATENCY_BEGIN_RWH_COMPONENT,
+                                   kLatencyComponentId, &component)) {
+      total_latency_ += base::TimeTicks::Now() - component.event_time;
+    }
     delete message;
     ++sent_count_;
     return true;
@@ -99,10 +115,17 @@ class NullIPCSender : public IPC::Sender {
     return message_count;
   }
 
+  TimeDelta GetAndResetTotalLatency() {
+    TimeDelta total_latency = total_latency_;
+    total_latency_ = TimeDelta();
+    return total_latency;
+  }
+
   bool HasMessages() const { return sent_count_ > 0; }
 
  private:
   size_t sent_count_;
+  TimeDelta total_latency_;
 };
 
 // TODO(jdduke): Use synthetic gesture pipeline, crbug.com/344598.
@@ -205,11 +228,15 @@ class InputRouterImplPerfTest : public testing::Test {
     sender_.reset(new NullIPCSender());
     client_.reset(new NullInputRouterClient());
     ack_handler_.reset(new NullInputAckHandler());
+    ResetInputRouter(InputRouterImpl::Config());
+  }
+
+  void ResetInputRouter(const InputRouterImpl::Config& config) {
     input_router_.reset(new InputRouterImpl(sender_.get(),
                                             client_.get(),
                                             ack_handler_.get(),
                                             MSG_ROUTING_NONE,
-                                            InputRouterImpl::Config()));
+                                            config));
   }
 
   void TearDown() override {
@@ -231,6 +258,10 @@ class InputRouterImplPerfTest : public testing::Test {
     input_router_->SendTouchEvent(TouchEventWithLatencyInfo(touch, latency));
   }
 
+  void SendEvent(const WebMouseEvent& mouse, const ui::LatencyInfo& latency) {
+    input_router_->SendMouseEvent(MouseEventWithLatencyInfo(mouse, latency));
+  }
+
   void SendEventAckIfNecessary(const blink::WebInputEvent& event,
                                InputEventAckState ack_result) {
     if (WebInputEventTraits::IgnoresAckDisposition(event))
@@ -261,11 +292,55 @@ class InputRouterImplPerfTest : public testing::Test {
     ui::LatencyInfo latency;
     latency.AddLatencyNumber(
         ui::INPUT_EVENT_LATENCY_SCROLL_UPDATE_ORIGINAL_COMPONENT, 1, 0);
-    latency.AddLatencyNumber(ui::INPUT_EVENT_LATENCY_BEGIN_RWH_COMPONENT, 1,
-                             NextLatencyID());
+    latency.AddLatencyNumber(ui::INPUT_EVENT_LATENCY_BEGIN_RWH_COMPONENT,
+                             kLatencyComponentId, NextLatencyID());
     return latency;
   }
 
+  // Feeds |move_count| mouse moves to the router at |input_rate_hz|, as from
+  // a high-rate mouse, acking each forwarded move right away. Reports how
+  // many moves reached the renderer and how long they waited in the router.
+  void SimulateHighRateMouseMoves(const char* test_name,
+                                  size_t move_count,
+                                  int input_rate_hz,
+                                  bool batch_mouse_moves) {
+    InputRouterImpl::Config config;
+    config.batch_mouse_moves = batch_mouse_moves;
+    ResetInputRouter(config);
+
+    const TimeDelta input_interval = TimeDelta::FromMicroseconds(
+        base::Time::kMicrosecondsPerSecond / input_rate_hz);
+    const WebMouseEvent move =
+        SyntheticWebMouseEventBuilder::Build(WebInputEvent::MouseMove);
+    size_t sent_count = 0;
+    for (size_t i = 0; i <= move_count; ++i) {
+      if (i < move_count)
+        SendEvent(move, CreateLatencyInfo());
+
+      // Let batched moves be flushed, and ack whatever was forwarded.
+      base::RunLoop run_loop;
+      base::MessageLoop::current()->PostDelayedTask(
+          FROM_HERE, run_loop.QuitClosure(),
+          i < move_count ? input_interval : TimeDelta::FromMilliseconds(50));
+      run_loop.Run();
+      size_t newly_sent;
+      while ((newly_sent = GetAndResetSentEventCount()) > 0) {
+        sent_count += newly_sent;
+        for (size_t j = 0; j < newly_sent; ++j)
+          SendEventAckIfNecessary(move, INPUT_EVENT_ACK_STATE_CONSUMED);
+      }
+    }
+
+    ASSERT_GT(sent_count, 0U);
+    perf_test::PrintResult("mouse_moves_forwarded", "", test_name, sent_count,
+                           "count", true);
+    perf_test::PrintResult(
+        "avg_forwarding_latency", "", test_name,
+        static_cast<size_t>(
+            (sender_->GetAndResetTotalLatency() / sent_count).InMicroseconds()),
+        "us", true);
+  }
+
   // TODO(jdduke): Use synthetic gesture pipeline, crbug.com/344598.
   template <typename EventType>
   void SimulateEventSequence(const char* test_name,
@@ -374,6 +449,14 @@ TEST_F(InputRouterImplPerfTest, GestureScrollDelayedAck) {
       kDefaultIterations);
 }
 
+TEST_F(InputRouterImplPerfTest, HighRateMouseMoves) {
+  SimulateHighRateMouseMoves("HighRateMouseMoves ", 500, 1000, false);
+}
+
+TEST_F(InputRouterImplPerfTest, HighRateMouseMovesBatched) {
+  SimulateHighRateMouseMoves("HighRateMouseMovesBatched ", 500, 1000, true);
+}
+
 TEST_F(InputRouterImplPerfTest, TouchSwipeToGestureScroll) {
   SimulateTouchAndScrollEventSequence("TouchSwipeToGestureScroll ",
                                       kDefaultSteps,
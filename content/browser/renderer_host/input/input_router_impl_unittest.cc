@@ -771,6 +771,36 @@ TEST_F(InputRouterImplTest, CoalescesWheelEvents) {
   EXPECT_EQ(0U, GetSentMessageCountAndResetSink());
 }
 
+// Test that with mouse move batching, at most one mouse move is forwarded per
+// vsync interval, even when the renderer acks right away.
+TEST_F(InputRouterImplTest, BatchesMouseMovesPerVSync) {
+  config_.batch_mouse_moves = true;
+  TearDown();
+  SetUp();
+
+  // A long interval keeps the test from racing the next vsync.
+  const base::TimeDelta kVSyncInterval = base::TimeDelta::FromMilliseconds(100);
+  input_router_->OnVSyncParametersChanged(base::TimeTicks::Now(),
+                                          kVSyncInterval);
+
+  // The first move in an interval is sent right away.
+  SimulateMouseEvent(WebInputEvent::MouseMove, 1, 1);
+  EXPECT_EQ(1u, GetSentMessageCountAndResetSink());
+  SendInputEventACK(WebInputEvent::MouseMove, INPUT_EVENT_ACK_STATE_CONSUMED);
+
+  // Later moves in the same interval are held and coalesced.
+  SimulateMouseEvent(WebInputEvent::MouseMove, 2, 2);
+  SimulateMouseEvent(WebInputEvent::MouseMove, 3, 3);
+  EXPECT_EQ(0u, GetSentMessageCountAndResetSink());
+  EXPECT_TRUE(HasPendingEvents());
+
+  // They are sent as one event at the next vsync.
+  RunTasksAndWait(kVSyncInterval * 2);
+  EXPECT_EQ(1u, GetSentMessageCountAndResetSink());
+  SendInputEventACK(WebInputEvent::MouseMove, INPUT_EVENT_ACK_STATE_CONSUMED);
+  EXPECT_FALSE(HasPendingEvents());
+}
+
 // Tests that touch-events are queued properly.
 TEST_F(InputRouterImplTest, TouchEventQueue) {
   OnHasTouchEventHandlers(true);
@@ -102,6 +102,8 @@ class MockInputRouter : public InputRouter {
   }
   bool ShouldForwardTouchEvent() const override { return true; }
   void OnViewUpdated(int view_flags) override {}
+  void OnVSyncParametersChanged(base::TimeTicks timebase,
+                                base::TimeDelta interval) override {}
   bool HasPendingEvents() const override { return false; }
 
   // IPC::Listener
@@ -350,6 +350,10 @@ const char kEnableLowResTiling[] = "enable-low-res-tiling";
 // Dynamically apply color profiles to web content images.
 const char kEnableImageColorProfiles[]      = "enable-image-color-profiles";
 
+// Limits the mouse move events forwarded to the renderer to one per display
+// frame, coalescing the ones in between.
+const char kEnableInputEventBatching[]      = "enable-input-event-batching";
+
 // Force logging to be enabled.  Logging is disabled by default in release
 // builds.
 const char kEnableLogging[]                 = "enable-logging";
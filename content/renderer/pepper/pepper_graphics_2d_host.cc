@@ -137,6 +137,8 @@ void ConvertImageData(PPB_ImageData_Impl* src_image,
 
 }  // namespace
 
+const size_t PepperGraphics2DHost::kMaxFrameDamageHistory = 4;
+
 struct PepperGraphics2DHost::QueuedOperation {
   enum Type { PAINT, SCROLL, REPLACE, };
 
@@ -189,7 +191,9 @@ PepperGraphics2DHost::PepperGraphics2DHost(RendererPpapiHost* host,
       is_always_opaque_(false),
       scale_(1.0f),
       is_running_in_process_(host->IsRunningInProcess()),
-      texture_mailbox_modified_(true) {}
+      texture_mailbox_modified_(true),
+      cached_bitmap_frame_(0),
+      frame_number_(0) {}
 
 PepperGraphics2DHost::~PepperGraphics2DHost() {
   // Unbind from the instance when destroyed if we're still bound.
@@ -550,8 +554,34 @@ int32_t PepperGraphics2DHost::OnHostMsgReadImageData(
   return ReadImageData(image, &top_left) ? PP_OK : PP_ERROR_FAILED;
 }
 
+void PepperGraphics2DHost::AddDamage(const gfx::Rect& rect) {
+  gfx::Rect image_rect(image_data_->width(), image_data_->height());
+  pending_damage_.Union(gfx::IntersectRects(rect, image_rect));
+}
+
+gfx::Rect PepperGraphics2DHost::GetDamageSinceFrame(int frame) const {
+  gfx::Rect image_rect(image_data_->width(), image_data_->height());
+  DCHECK_LE(frame, frame_number_);
+  size_t frames = frame_number_ - frame;
+  if (frames > frame_damage_.size())
+    return image_rect;
+  gfx::Rect damage = pending_damage_;
+  for (size_t i = frame_damage_.size() - frames; i < frame_damage_.size(); ++i)
+    damage.Union(frame_damage_[i]);
+  return damage;
+}
+
+void PepperGraphics2DHost::DidSendFrame() {
+  frame_damage_.push_back(pending_damage_);
+  if (frame_damage_.size() > kMaxFrameDamageHistory)
+    frame_damage_.pop_front();
+  pending_damage_ = gfx::Rect();
+  ++frame_number_;
+}
+
 void PepperGraphics2DHost::ReleaseCallback(scoped_ptr<cc::SharedBitmap> bitmap,
                                            const gfx::Size& bitmap_size,
+                                           int bitmap_frame,
                                            uint32 sync_point,
                                            bool lost_resource) {
   cached_bitmap_.reset();
@@ -560,6 +590,7 @@ void PepperGraphics2DHost::ReleaseCallback(scoped_ptr<cc::SharedBitmap> bitmap,
   if (need_flush_ack_ && bound_instance_)
     cached_bitmap_ = bitmap.Pass();
   cached_bitmap_size_ = bitmap_size;
+  cached_bitmap_frame_ = bitmap_frame;
 }
 
 bool PepperGraphics2DHost::PrepareTextureMailbox(
@@ -569,12 +600,17 @@ bool PepperGraphics2DHost::PrepareTextureMailbox(
     return false;
   // TODO(jbauman): Send image_data_ through mailbox to avoid copy.
   gfx::Size pixel_image_size(image_data_->width(), image_data_->height());
+  gfx::Rect copy_rect(pixel_image_size);
   scoped_ptr<cc::SharedBitmap> shared_bitmap;
   if (cached_bitmap_) {
-    if (cached_bitmap_size_ == pixel_image_size)
+    if (cached_bitmap_size_ == pixel_image_size) {
+      // A recycled bitmap already holds an older frame, so only the pixels
+      // painted since then need to be transferred.
       shared_bitmap = cached_bitmap_.Pass();
-    else
+      copy_rect = GetDamageSinceFrame(cached_bitmap_frame_);
+    } else {
       cached_bitmap_.reset();
+    }
   }
   if (!shared_bitmap) {
     shared_bitmap = RenderThreadImpl::current()
@@ -583,18 +619,31 @@ bool PepperGraphics2DHost::PrepareTextureMailbox(
   }
   if (!shared_bitmap)
     return false;
-  void* src = image_data_->Map();
-  memcpy(shared_bitmap->pixels(),
-         src,
-         cc::SharedBitmap::CheckedSizeInBytes(pixel_image_size));
+  uint8* src = static_cast<uint8*>(image_data_->Map());
+  uint8* dest = shared_bitmap->pixels();
+  if (copy_rect == gfx::Rect(pixel_image_size)) {
+    memcpy(dest, src, cc::SharedBitmap::CheckedSizeInBytes(pixel_image_size));
+  } else {
+    const size_t stride = pixel_image_size.width() * 4;
+    const size_t offset = copy_rect.y() * stride + copy_rect.x() * 4;
+    const size_t row_bytes = copy_rect.width() * 4;
+    for (int row = 0; row < copy_rect.height(); ++row) {
+      memcpy(dest + offset + row * stride,
+             src + offset + row * stride,
+             row_bytes);
+    }
+  }
   image_data_->Unmap();
 
+  DidSendFrame();
+
   *mailbox = cc::TextureMailbox(shared_bitmap.get(), pixel_image_size);
   *release_callback = cc::SingleReleaseCallback::Create(
       base::Bind(&PepperGraphics2DHost::ReleaseCallback,
                  this->AsWeakPtr(),
                  base::Passed(&shared_bitmap),
-                 pixel_image_size));
+                 pixel_image_size,
+                 frame_number_));
   texture_mailbox_modified_ = false;
   return true;
 }
@@ -635,6 +684,7 @@ int32_t PepperGraphics2DHost::Flush(PP_Resource* old_image_data) {
         done_replace_contents = true;
         break;
     }
+    AddDamage(op_rect);
 
     // For correctness with accelerated compositing, we must issue an invalidate
     // on the full op_rect even if it is partially or completely off-screen.
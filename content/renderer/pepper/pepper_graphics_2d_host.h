@@ -5,6 +5,7 @@
 #ifndef CONTENT_RENDERER_PEPPER_PEPPER_GRAPHICS_2D_HOST_H_
 #define CONTENT_RENDERER_PEPPER_PEPPER_GRAPHICS_2D_HOST_H_
 
+#include <deque>
 #include <vector>
 
 #include "base/basictypes.h"
@@ -17,6 +18,7 @@
 #include "third_party/WebKit/public/platform/WebCanvas.h"
 #include "ui/events/latency_info.h"
 #include "ui/gfx/geometry/point.h"
+#include "ui/gfx/geometry/rect.h"
 #include "ui/gfx/geometry/size.h"
 
 namespace cc {
@@ -25,10 +27,6 @@ class SingleReleaseCallback;
 class TextureMailbox;
 }
 
-namespace gfx {
-class Rect;
-}
-
 namespace ppapi {
 struct ViewData;
 }
@@ -159,11 +157,29 @@ class CONTENT_EXPORT PepperGraphics2DHost
                                      gfx::Rect* op_rect,
                                      gfx::Point* delta);
 
+  // Records |rect|, in backing store pixels, as changed since the last frame
+  // was sent to the compositor.
+  void AddDamage(const gfx::Rect& rect);
+
+  // Returns the area of the backing store that changed after |frame| was
+  // sent to the compositor, or the whole backing store if that is no longer
+  // known.
+  gfx::Rect GetDamageSinceFrame(int frame) const;
+
+  // Moves the damage recorded since the last frame into the history, once the
+  // backing store has been sent to the compositor as a new frame.
+  void DidSendFrame();
+
   void ReleaseCallback(scoped_ptr<cc::SharedBitmap> bitmap,
                        const gfx::Size& bitmap_size,
+                       int bitmap_frame,
                        uint32 sync_point,
                        bool lost_resource);
 
+  // Number of frames whose damage is remembered. A released bitmap older than
+  // this is refreshed with a full copy of the backing store.
+  static const size_t kMaxFrameDamageHistory;
+
   RendererPpapiHost* renderer_ppapi_host_;
 
   scoped_refptr<PPB_ImageData_Impl> image_data_;
@@ -205,6 +221,20 @@ class CONTENT_EXPORT PepperGraphics2DHost
   scoped_ptr<cc::SharedBitmap> cached_bitmap_;
   gfx::Size cached_bitmap_size_;
 
+  // The frame whose contents |cached_bitmap_| holds. Only the area damaged
+  // since then has to be copied when the bitmap is reused.
+  int cached_bitmap_frame_;
+
+  // Number of frames sent to the compositor so far.
+  int frame_number_;
+
+  // Area of the backing store changed since frame |frame_number_| was sent.
+  gfx::Rect pending_damage_;
+
+  // Damage of the most recent frames, oldest first; the last entry is the
+  // area that changed between frames |frame_number_| - 1 and |frame_number_|.
+  std::deque<gfx::Rect> frame_damage_;
+
   friend class PepperGraphics2DHostTest;
   DISALLOW_COPY_AND_ASSIGN(PepperGraphics2DHost);
 };
@@ -31,6 +31,10 @@ class PepperGraphics2DHostTest : public testing::Test {
     return PepperGraphics2DHost::ConvertToLogicalPixels(scale, op_rect, delta);
   }
 
+  static size_t max_frame_damage_history() {
+    return PepperGraphics2DHost::kMaxFrameDamageHistory;
+  }
+
   PepperGraphics2DHostTest() : renderer_ppapi_host_(NULL, 12345) {}
 
   ~PepperGraphics2DHostTest() override {
@@ -71,6 +75,18 @@ class PepperGraphics2DHostTest : public testing::Test {
     host_->SendOffscreenFlushAck();
   }
 
+  void AddDamage(const gfx::Rect& rect) { host_->AddDamage(rect); }
+
+  // Returns the number of the frame just sent.
+  int SendFrame() {
+    host_->DidSendFrame();
+    return host_->frame_number_;
+  }
+
+  gfx::Rect GetDamageSinceFrame(int frame) {
+    return host_->GetDamageSinceFrame(frame);
+  }
+
   void PaintToWebCanvas(SkBitmap* bitmap) {
     scoped_ptr<WebCanvas> canvas(new WebCanvas(*bitmap));
     gfx::Rect plugin_rect(PP_ToGfxRect(renderer_view_data_.rect));
@@ -165,4 +181,59 @@ TEST_F(PepperGraphics2DHostTest, ConvertToLogicalPixels) {
   }
 }
 
+// A recycled bitmap only needs the area painted since the frame it holds.
+TEST_F(PepperGraphics2DHostTest, DamageSinceFrame) {
+  ppapi::ProxyAutoLock proxy_lock;
+
+  PP_Instance instance = 12345;
+  PP_Size backing_store_size = PP_MakeSize(100, 100);
+  PP_Rect plugin_rect = PP_MakeRectFromXYWH(0, 0, 100, 100);
+  Init(instance, backing_store_size, plugin_rect);
+
+  int frame = SendFrame();
+  EXPECT_TRUE(GetDamageSinceFrame(frame).IsEmpty());
+
+  // Flushed paints are recorded as damage.
+  scoped_refptr<PPB_ImageData_Impl> image_data(
+      new PPB_ImageData_Impl(instance, PPB_ImageData_Impl::ForTest()));
+  ASSERT_TRUE(image_data->Init(PPB_ImageData_Impl::GetNativeImageDataFormat(),
+                               10, 10, true));
+  PaintImageData(image_data.get());
+  Flush();
+  EXPECT_EQ(gfx::Rect(0, 0, 10, 10), GetDamageSinceFrame(frame));
+
+  // Damage outside of the backing store is dropped.
+  int next_frame = SendFrame();
+  AddDamage(gfx::Rect(20, 90, 20, 20));
+  EXPECT_EQ(gfx::Rect(20, 90, 20, 10), GetDamageSinceFrame(next_frame));
+  EXPECT_EQ(gfx::Rect(0, 0, 40, 100), GetDamageSinceFrame(frame));
+
+  SendFrame();
+  EXPECT_EQ(gfx::Rect(20, 90, 20, 10), GetDamageSinceFrame(next_frame));
+  EXPECT_EQ(gfx::Rect(0, 0, 40, 100), GetDamageSinceFrame(frame));
+}
+
+// Bitmaps older than the damage history are refreshed with a full copy.
+TEST_F(PepperGraphics2DHostTest, DamageHistoryOverflow) {
+  ppapi::ProxyAutoLock proxy_lock;
+
+  PP_Instance instance = 12345;
+  PP_Size backing_store_size = PP_MakeSize(100, 100);
+  PP_Rect plugin_rect = PP_MakeRectFromXYWH(0, 0, 100, 100);
+  Init(instance, backing_store_size, plugin_rect);
+
+  const int history = static_cast<int>(max_frame_damage_history());
+  int frame = SendFrame();
+  for (int i = 0; i < history; ++i) {
+    AddDamage(gfx::Rect(i, 0, 1, 1));
+    SendFrame();
+  }
+  EXPECT_EQ(gfx::Rect(0, 0, history, 1), GetDamageSinceFrame(frame));
+
+  AddDamage(gfx::Rect(0, 50, 1, 1));
+  SendFrame();
+  EXPECT_EQ(gfx::Rect(0, 0, 100, 100), GetDamageSinceFrame(frame));
+  EXPECT_EQ(gfx::Rect(0, 0, history, 51), GetDamageSinceFrame(frame + 1));
+}
+
 }  // namespace content
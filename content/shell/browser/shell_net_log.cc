@@ -8,6 +8,7 @@
 
 #include "base/command_line.h"
 #include "base/files/file_path.h"
+#include "base/threading/thread.h"
 #include "base/values.h"
 #include "content/public/common/content_switches.h"
 #include "net/base/net_log_logger.h"
@@ -42,11 +43,9 @@ ShellNetLog::ShellNetLog(const std::string& app_name) {
     base::FilePath log_path =
         command_line->GetSwitchValuePath(switches::kLogNetLog);
     // Much like logging.h, bypass threading restrictions by using fopen
-    // directly.  Have to write on a thread that's shutdown to handle events on
-    // shutdown properly, and posting events to another thread as they occur
-    // would result in an unbounded buffer size, so not much can be gained by
-    // doing this on another thread.  It's only used when debugging, so
-    // performance is not a big concern.
+    // directly.  Events are written on a thread owned by this NetLog, rather
+    // than a BrowserThread, so that events logged during shutdown are still
+    // written, while the network thread doesn't block on disk writes.
     FILE* file = NULL;
 #if defined(OS_WIN)
     file = _wfopen(log_path.value().c_str(), L"w");
@@ -59,7 +58,10 @@ ShellNetLog::ShellNetLog(const std::string& app_name) {
                  << " for net logging";
     } else {
       scoped_ptr<base::Value> constants(GetShellConstants(app_name));
-      net_log_logger_.reset(new net::NetLogLogger(file, *constants));
+      net_log_file_thread_.reset(new base::Thread("NetLogFileThread"));
+      net_log_file_thread_->Start();
+      net_log_logger_.reset(new net::NetLogLogger(
+          file, *constants, net_log_file_thread_->message_loop_proxy()));
       net_log_logger_->StartObserving(this);
     }
   }
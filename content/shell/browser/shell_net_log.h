@@ -10,6 +10,10 @@
 #include "base/memory/scoped_ptr.h"
 #include "net/base/net_log_logger.h"
 
+namespace base {
+class Thread;
+}
+
 namespace content {
 
 class ShellNetLog : public net::NetLog {
@@ -18,6 +22,9 @@ class ShellNetLog : public net::NetLog {
   ~ShellNetLog() override;
 
  private:
+  // Writes |net_log_logger_|'s file. Declared first so that it is stopped,
+  // after the logger's final writes, once the logger is gone.
+  scoped_ptr<base::Thread> net_log_file_thread_;
   scoped_ptr<net::NetLogLogger> net_log_logger_;
 
   DISALLOW_COPY_AND_ASSIGN(ShellNetLog);
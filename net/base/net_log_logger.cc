@@ -6,32 +6,140 @@
 
 #include <stdio.h>
 
+#include "base/bind.h"
+#include "base/files/scoped_file.h"
 #include "base/json/json_writer.h"
+#include "base/location.h"
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
+#include "base/sequenced_task_runner.h"
+#include "base/synchronization/lock.h"
 #include "base/values.h"
 #include "net/base/net_log_util.h"
 
 namespace net {
 
+// Owns the log file, and the events which have been captured but not yet
+// written to it. All file access happens on a single thread at a time: the
+// logging thread in synchronous mode, or the file task runner otherwise.
+class NetLogLogger::FileWriter
+    : public base::RefCountedThreadSafe<NetLogLogger::FileWriter> {
+ public:
+  FileWriter(FILE* file, const base::Value& constants)
+      : file_(file), added_events_(false), dropped_entries_(0) {
+    DCHECK(file);
+
+    // Write constants to the output file.  This allows loading files that
+    // have different source and event types, as they may be added and removed
+    // between Chrome versions.
+    std::string json;
+    base::JSONWriter::Write(&constants, &json);
+    fprintf(file_.get(), "{\"constants\": %s,\n", json.c_str());
+    fprintf(file_.get(), "\"events\": [\n");
+  }
+
+  // Writes a single event to the file.
+  void WriteValue(const base::Value& value) {
+    // Add a comma and newline for every event but the first.  Newlines are
+    // needed so can load partial log files by just ignoring the last line.
+    // For this to work, lines cannot be pretty printed.
+    std::string json;
+    base::JSONWriter::Write(&value, &json);
+    fprintf(file_.get(), "%s%s",
+            (added_events_ ? ",\n" : ""),
+            json.c_str());
+    added_events_ = true;
+  }
+
+  // Queues |value| to be written by the next WritePendingEntries(), or drops
+  // it if kMaxPendingEntries are already queued, so that a file thread which
+  // falls behind can't make the queue grow without bound. May be called on
+  // any thread. Returns true if the queue was empty, in which case the caller
+  // is responsible for scheduling a WritePendingEntries() call.
+  bool AddPendingEntry(scoped_ptr<base::Value> value) {
+    base::AutoLock lock(lock_);
+    if (pending_entries_.size() >= kMaxPendingEntries) {
+      ++dropped_entries_;
+      return false;
+    }
+    pending_entries_.push_back(value.release());
+    return pending_entries_.size() == 1;
+  }
+
+  // Writes out every queued event. Must be called on the file task runner.
+  void WritePendingEntries() {
+    ScopedVector<base::Value> entries;
+    {
+      base::AutoLock lock(lock_);
+      entries.swap(pending_entries_);
+    }
+    for (size_t i = 0; i < entries.size(); ++i)
+      WriteValue(*entries[i]);
+  }
+
+  // Writes out any remaining events and terminates the JSON document.
+  void Close() {
+    WritePendingEntries();
+    fprintf(file_.get(), "]}");
+    file_.reset();
+
+    base::AutoLock lock(lock_);
+    LOG_IF(WARNING, dropped_entries_ > 0)
+        << "NetLog dropped " << dropped_entries_
+        << " events that the file thread could not keep up with.";
+  }
+
+ private:
+  friend class base::RefCountedThreadSafe<FileWriter>;
+
+  ~FileWriter() {}
+
+  base::ScopedFILE file_;
+
+  // True if WriteValue() has been called at least once.
+  bool added_events_;
+
+  // Protects |pending_entries_| and |dropped_entries_|. The queue is filled
+  // on the logging threads and drained on the file task runner.
+  base::Lock lock_;
+  ScopedVector<base::Value> pending_entries_;
+
+  // Number of events dropped because the queue was full.
+  size_t dropped_entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(FileWriter);
+};
+
+const size_t NetLogLogger::kMaxPendingEntries = 10000;
+
 NetLogLogger::NetLogLogger(FILE* file, const base::Value& constants)
-    : file_(file),
-      log_level_(NetLog::LOG_STRIP_PRIVATE_DATA),
-      added_events_(false) {
-  DCHECK(file);
-
-  // Write constants to the output file.  This allows loading files that have
-  // different source and event types, as they may be added and removed
-  // between Chrome versions.
-  std::string json;
-  base::JSONWriter::Write(&constants, &json);
-  fprintf(file_.get(), "{\"constants\": %s,\n", json.c_str());
-  fprintf(file_.get(), "\"events\": [\n");
+    : file_writer_(new FileWriter(file, constants)),
+      log_level_(NetLog::LOG_STRIP_PRIVATE_DATA) {
+}
+
+NetLogLogger::NetLogLogger(
+    FILE* file,
+    const base::Value& constants,
+    const scoped_refptr<base::SequencedTaskRunner>& file_task_runner)
+    : file_writer_(new FileWriter(file, constants)),
+      file_task_runner_(file_task_runner),
+      log_level_(NetLog::LOG_STRIP_PRIVATE_DATA) {
+  DCHECK(file_task_runner_.get());
 }
 
 NetLogLogger::~NetLogLogger() {
-  if (file_.get())
-    fprintf(file_.get(), "]}");
+  // Events can no longer be added, so any write tasks still in flight will
+  // find nothing to write once the file has been closed. If the file task
+  // runner is already gone, so are those tasks, and closing here is the only
+  // way to write out the queued events and complete the JSON.
+  if (file_task_runner_.get() &&
+      !file_task_runner_->RunsTasksOnCurrentThread() &&
+      file_task_runner_->PostTask(
+          FROM_HERE, base::Bind(&FileWriter::Close, file_writer_))) {
+    return;
+  }
+  file_writer_->Close();
 }
 
 void NetLogLogger::set_log_level(net::NetLog::LogLevel log_level) {
@@ -48,16 +156,20 @@ void NetLogLogger::StopObserving() {
 }
 
 void NetLogLogger::OnAddEntry(const net::NetLog::Entry& entry) {
-  // Add a comma and newline for every event but the first.  Newlines are needed
-  // so can load partial log files by just ignoring the last line.  For this to
-  // work, lines cannot be pretty printed.
+  // The Value must be built here, since the entry's ParametersCallback may
+  // reference data that does not outlive this call.
   scoped_ptr<base::Value> value(entry.ToValue());
-  std::string json;
-  base::JSONWriter::Write(value.get(), &json);
-  fprintf(file_.get(), "%s%s",
-          (added_events_ ? ",\n" : ""),
-          json.c_str());
-  added_events_ = true;
+  if (!file_task_runner_.get()) {
+    file_writer_->WriteValue(*value);
+    return;
+  }
+
+  // Only the first event of a batch schedules a write; the rest are picked
+  // up by that same task.
+  if (file_writer_->AddPendingEntry(value.Pass())) {
+    file_task_runner_->PostTask(
+        FROM_HERE, base::Bind(&FileWriter::WritePendingEntries, file_writer_));
+  }
 }
 
 // static
@@ -7,13 +7,14 @@
 
 #include <stdio.h>
 
-#include "base/files/scoped_file.h"
 #include "base/macros.h"
+#include "base/memory/ref_counted.h"
 #include "net/base/net_log.h"
 
 namespace base {
 class DictionaryValue;
 class FilePath;
+class SequencedTaskRunner;
 class Value;
 }
 
@@ -25,10 +26,27 @@ namespace net {
 // The text file will contain a single JSON object.
 class NET_EXPORT NetLogLogger : public NetLog::ThreadSafeObserver {
  public:
+  // Most events waiting to be written on the file task runner.
+  static const size_t kMaxPendingEntries;
+
   // Takes ownership of |file| and will write network events to it once logging
   // starts.  |file| must be non-NULL handle and be open for writing.
   // |constants| is a legend for decoding constant values used in the log.
   NetLogLogger(FILE* file, const base::Value& constants);
+
+  // Same as above, except that events are only serialized to JSON and written
+  // to |file| on |file_task_runner|, in batches. The logging threads still
+  // build each event's Value, since its parameters must be evaluated
+  // synchronously. At most kMaxPendingEntries events wait to be written;
+  // further events are dropped until the file thread catches up. Remaining
+  // events are written out and |file| is closed on |file_task_runner| after
+  // destruction, or during it when destroyed on |file_task_runner| or after
+  // |file_task_runner| has stopped running tasks.
+  NetLogLogger(
+      FILE* file,
+      const base::Value& constants,
+      const scoped_refptr<base::SequencedTaskRunner>& file_task_runner);
+
   ~NetLogLogger() override;
 
   // Sets the log level to log at. Must be called before StartObserving.
@@ -52,14 +70,18 @@ class NET_EXPORT NetLogLogger : public NetLog::ThreadSafeObserver {
   static base::DictionaryValue* GetConstants();
 
  private:
-  base::ScopedFILE file_;
+  class FileWriter;
+
+  // Owns the output file. Shared with tasks posted to |file_task_runner_|.
+  scoped_refptr<FileWriter> file_writer_;
+
+  // Where events are written, or NULL to write them synchronously from
+  // OnAddEntry().
+  scoped_refptr<base::SequencedTaskRunner> file_task_runner_;
 
   // The LogLevel to log at.
   NetLog::LogLevel log_level_;
 
-  // True if OnAddEntry() has been called at least once.
-  bool added_events_;
-
   DISALLOW_COPY_AND_ASSIGN(NetLogLogger);
 };
 
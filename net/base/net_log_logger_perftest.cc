@@ -0,0 +1,123 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/base/net_log_logger.h"
+
+#include <string>
+
+#include "base/bind.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/message_loop/message_loop.h"
+#include "base/run_loop.h"
+#include "base/threading/thread.h"
+#include "base/time/time.h"
+#include "base/values.h"
+#include "net/base/net_log.h"
+#include "net/base/net_log_util.h"
+#include "net/test/embedded_test_server/embedded_test_server.h"
+#include "net/test/embedded_test_server/http_request.h"
+#include "net/test/embedded_test_server/http_response.h"
+#include "net/url_request/url_request.h"
+#include "net/url_request/url_request_test_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace net {
+
+namespace {
+
+// Number of requests made to the loopback server for each configuration.
+const int kNumRequests = 500;
+
+scoped_ptr<test_server::HttpResponse> HandleRequest(
+    const test_server::HttpRequest& request) {
+  scoped_ptr<test_server::BasicHttpResponse> response(
+      new test_server::BasicHttpResponse);
+  response->set_code(HTTP_OK);
+  response->set_content_type("text/plain");
+  response->set_content(std::string(16 * 1024, 'x'));
+  return response.Pass();
+}
+
+class NetLogLoggerPerfTest : public testing::Test {
+ public:
+  NetLogLoggerPerfTest() : message_loop_(base::MessageLoop::TYPE_IO) {}
+
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    test_server_.RegisterRequestHandler(base::Bind(&HandleRequest));
+    ASSERT_TRUE(test_server_.InitializeAndWaitUntilReady());
+  }
+
+  void TearDown() override {
+    ASSERT_TRUE(test_server_.ShutdownAndWaitUntilComplete());
+  }
+
+ protected:
+  // Fetches a loopback URL kNumRequests times using |net_log|, and reports
+  // the time per request as |trace|.
+  void RunRequests(NetLog* net_log, const std::string& trace) {
+    TestURLRequestContext context(true);
+    context.set_net_log(net_log);
+    context.Init();
+
+    base::TimeTicks start = base::TimeTicks::Now();
+    for (int i = 0; i < kNumRequests; ++i) {
+      TestDelegate delegate;
+      scoped_ptr<URLRequest> request(context.CreateRequest(
+          test_server_.GetURL("/"), DEFAULT_PRIORITY, &delegate, NULL));
+      request->Start();
+      base::RunLoop().Run();
+      ASSERT_TRUE(request->status().is_success());
+    }
+    base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+
+    perf_test::PrintResult("net_log_overhead", "", trace,
+                           elapsed.InMillisecondsF() * 1000 / kNumRequests,
+                           "us/request", true);
+  }
+
+  FILE* OpenLogFile(const std::string& name) {
+    return base::OpenFile(temp_dir_.path().AppendASCII(name), "w");
+  }
+
+  base::MessageLoop message_loop_;
+  base::ScopedTempDir temp_dir_;
+  test_server::EmbeddedTestServer test_server_;
+};
+
+TEST_F(NetLogLoggerPerfTest, LoopbackRequests) {
+  scoped_ptr<base::Value> constants(GetNetConstants());
+
+  {
+    NetLog net_log;
+    RunRequests(&net_log, "not_logging");
+  }
+
+  {
+    NetLog net_log;
+    NetLogLogger logger(OpenLogFile("sync.json"), *constants);
+    logger.set_log_level(NetLog::LOG_ALL_BUT_BYTES);
+    logger.StartObserving(&net_log);
+    RunRequests(&net_log, "synchronous_writes");
+    logger.StopObserving();
+  }
+
+  {
+    base::Thread file_thread("NetLogFileThread");
+    ASSERT_TRUE(file_thread.Start());
+    NetLog net_log;
+    NetLogLogger logger(OpenLogFile("async.json"), *constants,
+                        file_thread.message_loop_proxy());
+    logger.set_log_level(NetLog::LOG_ALL_BUT_BYTES);
+    logger.StartObserving(&net_log);
+    RunRequests(&net_log, "file_thread_writes");
+    logger.StopObserving();
+  }
+}
+
+}  // namespace
+
+}  // namespace net
@@ -8,6 +8,8 @@
 #include "base/files/file_util.h"
 #include "base/files/scoped_temp_dir.h"
 #include "base/json/json_reader.h"
+#include "base/test/test_simple_task_runner.h"
+#include "base/threading/thread.h"
 #include "base/values.h"
 #include "net/base/net_log.h"
 #include "net/base/net_log_util.h"
@@ -136,6 +138,175 @@ TEST_F(NetLogLoggerTest, GeneratesValidJSONWithMultipleEvents) {
   ASSERT_EQ(2u, events->GetSize());
 }
 
+TEST_F(NetLogLoggerTest, WritesOnFileTaskRunner) {
+  FILE* file = base::OpenFile(log_path_, "w");
+  ASSERT_TRUE(file);
+  scoped_ptr<base::Value> constants(GetNetConstants());
+  scoped_refptr<base::TestSimpleTaskRunner> file_task_runner(
+      new base::TestSimpleTaskRunner());
+  scoped_ptr<NetLogLogger> logger(
+      new NetLogLogger(file, *constants, file_task_runner));
+
+  const int kDummyId = 1;
+  NetLog::Source source(NetLog::SOURCE_SPDY_SESSION, kDummyId);
+  NetLog::ParametersCallback params =
+      NetLog::IntegerCallback("dummy_param", 42);
+  NetLog::EntryData entry_data(NetLog::TYPE_PROXY_SERVICE,
+                               source,
+                               NetLog::PHASE_BEGIN,
+                               base::TimeTicks::Now(),
+                               &params);
+  NetLog::Entry entry(&entry_data, NetLog::LOG_ALL);
+
+  // Entries added back to back are written by a single task.
+  logger->OnAddEntry(entry);
+  logger->OnAddEntry(entry);
+  EXPECT_EQ(1u, file_task_runner->GetPendingTasks().size());
+  file_task_runner->RunPendingTasks();
+
+  logger->OnAddEntry(entry);
+  EXPECT_EQ(1u, file_task_runner->GetPendingTasks().size());
+
+  // Destroying the logger on the task runner's thread completes the file
+  // immediately. The write task still queued then has nothing left to do.
+  logger.reset();
+  file_task_runner->RunPendingTasks();
+
+  std::string input;
+  ASSERT_TRUE(base::ReadFileToString(log_path_, &input));
+
+  base::JSONReader reader;
+  scoped_ptr<base::Value> root(reader.ReadToValue(input));
+  ASSERT_TRUE(root) << reader.GetErrorMessage();
+
+  base::DictionaryValue* dict;
+  ASSERT_TRUE(root->GetAsDictionary(&dict));
+  base::ListValue* events;
+  ASSERT_TRUE(dict->GetList("events", &events));
+  ASSERT_EQ(3u, events->GetSize());
+
+  base::DictionaryValue* event;
+  ASSERT_TRUE(events->GetDictionary(2, &event));
+  int value = 0;
+  EXPECT_TRUE(event->GetInteger("params.dummy_param", &value));
+  EXPECT_EQ(42, value);
+  int type = -1;
+  EXPECT_TRUE(event->GetInteger("source.type", &type));
+  EXPECT_EQ(NetLog::SOURCE_SPDY_SESSION, type);
+}
+
+TEST_F(NetLogLoggerTest, ClosesOnFileThread) {
+  base::Thread file_thread("NetLogFileThread");
+  ASSERT_TRUE(file_thread.Start());
+  FILE* file = base::OpenFile(log_path_, "w");
+  ASSERT_TRUE(file);
+  scoped_ptr<base::Value> constants(GetNetConstants());
+  scoped_ptr<NetLogLogger> logger(
+      new NetLogLogger(file, *constants, file_thread.message_loop_proxy()));
+
+  NetLog::Source source(NetLog::SOURCE_SPDY_SESSION, 1);
+  NetLog::EntryData entry_data(NetLog::TYPE_PROXY_SERVICE,
+                               source,
+                               NetLog::PHASE_BEGIN,
+                               base::TimeTicks::Now(),
+                               NULL);
+  NetLog::Entry entry(&entry_data, NetLog::LOG_ALL);
+  logger->OnAddEntry(entry);
+
+  // The file is completed on the file thread after the logger is gone.
+  logger.reset();
+  file_thread.Stop();
+
+  std::string input;
+  ASSERT_TRUE(base::ReadFileToString(log_path_, &input));
+
+  base::JSONReader reader;
+  scoped_ptr<base::Value> root(reader.ReadToValue(input));
+  ASSERT_TRUE(root) << reader.GetErrorMessage();
+
+  base::DictionaryValue* dict;
+  ASSERT_TRUE(root->GetAsDictionary(&dict));
+  base::ListValue* events;
+  ASSERT_TRUE(dict->GetList("events", &events));
+  ASSERT_EQ(1u, events->GetSize());
+}
+
+TEST_F(NetLogLoggerTest, ClosesAfterFileThreadStops) {
+  base::Thread file_thread("NetLogFileThread");
+  ASSERT_TRUE(file_thread.Start());
+  FILE* file = base::OpenFile(log_path_, "w");
+  ASSERT_TRUE(file);
+  scoped_ptr<base::Value> constants(GetNetConstants());
+  scoped_ptr<NetLogLogger> logger(
+      new NetLogLogger(file, *constants, file_thread.message_loop_proxy()));
+  file_thread.Stop();
+
+  NetLog::Source source(NetLog::SOURCE_SPDY_SESSION, 1);
+  NetLog::EntryData entry_data(NetLog::TYPE_PROXY_SERVICE,
+                               source,
+                               NetLog::PHASE_BEGIN,
+                               base::TimeTicks::Now(),
+                               NULL);
+  NetLog::Entry entry(&entry_data, NetLog::LOG_ALL);
+  logger->OnAddEntry(entry);
+
+  // With no file thread left to post to, the logger writes the queued event
+  // and completes the file itself.
+  logger.reset();
+
+  std::string input;
+  ASSERT_TRUE(base::ReadFileToString(log_path_, &input));
+
+  base::JSONReader reader;
+  scoped_ptr<base::Value> root(reader.ReadToValue(input));
+  ASSERT_TRUE(root) << reader.GetErrorMessage();
+
+  base::DictionaryValue* dict;
+  ASSERT_TRUE(root->GetAsDictionary(&dict));
+  base::ListValue* events;
+  ASSERT_TRUE(dict->GetList("events", &events));
+  ASSERT_EQ(1u, events->GetSize());
+}
+
+TEST_F(NetLogLoggerTest, DropsEventsWhenFileThreadFallsBehind) {
+  FILE* file = base::OpenFile(log_path_, "w");
+  ASSERT_TRUE(file);
+  scoped_ptr<base::Value> constants(GetNetConstants());
+  scoped_refptr<base::TestSimpleTaskRunner> file_task_runner(
+      new base::TestSimpleTaskRunner());
+  scoped_ptr<NetLogLogger> logger(
+      new NetLogLogger(file, *constants, file_task_runner));
+
+  NetLog::Source source(NetLog::SOURCE_SPDY_SESSION, 1);
+  NetLog::EntryData entry_data(NetLog::TYPE_PROXY_SERVICE,
+                               source,
+                               NetLog::PHASE_BEGIN,
+                               base::TimeTicks::Now(),
+                               NULL);
+  NetLog::Entry entry(&entry_data, NetLog::LOG_ALL);
+  for (size_t i = 0; i < NetLogLogger::kMaxPendingEntries + 10; ++i)
+    logger->OnAddEntry(entry);
+  file_task_runner->RunPendingTasks();
+
+  // Once the queue has drained, events are queued again.
+  logger->OnAddEntry(entry);
+  logger.reset();
+  file_task_runner->RunPendingTasks();
+
+  std::string input;
+  ASSERT_TRUE(base::ReadFileToString(log_path_, &input));
+
+  base::JSONReader reader;
+  scoped_ptr<base::Value> root(reader.ReadToValue(input));
+  ASSERT_TRUE(root) << reader.GetErrorMessage();
+
+  base::DictionaryValue* dict;
+  ASSERT_TRUE(root->GetAsDictionary(&dict));
+  base::ListValue* events;
+  ASSERT_TRUE(dict->GetList("events", &events));
+  ASSERT_EQ(NetLogLogger::kMaxPendingEntries + 1, events->GetSize());
+}
+
 }  // namespace
 
 }  // namespace net
@@ -0,0 +1,298 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/proxy/caching_proxy_resolver.h"
+
+#include <map>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/strings/string_util.h"
+#include "base/strings/utf_string_conversions.h"
+#include "net/base/net_errors.h"
+
+namespace net {
+
+namespace {
+
+// Identifiers which make the result of FindProxyForURL() vary over time for
+// the same input, so the script's results can never be cached.
+const char* const kNonDeterministicIdentifiers[] = {
+  "timeRange",
+  "dateRange",
+  "weekdayRange",
+  "Date",
+  "random",
+};
+
+bool IsIdentifierStart(base::char16 c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' ||
+         c == '$';
+}
+
+bool IsIdentifierPart(base::char16 c) {
+  return IsIdentifierStart(c) || (c >= '0' && c <= '9');
+}
+
+// A very small javascript scanner. It only understands identifiers and
+// skips everything else, including the contents of string literals and
+// comments (which may produce spurious identifiers -- that only ever makes
+// the analysis more conservative).
+class ScriptScanner {
+ public:
+  explicit ScriptScanner(const base::string16& script)
+      : script_(script), pos_(0) {}
+
+  bool AtEnd() const { return pos_ >= script_.size(); }
+
+  void SkipWhitespace() {
+    while (!AtEnd() && IsWhitespace(script_[pos_]))
+      ++pos_;
+  }
+
+  // Consumes |c| (after any whitespace) and returns true if it is next.
+  bool ConsumeChar(char c) {
+    SkipWhitespace();
+    if (AtEnd() || script_[pos_] != c)
+      return false;
+    ++pos_;
+    return true;
+  }
+
+  // Reads an identifier (after any whitespace) into |identifier|. Returns
+  // false and consumes nothing if the next token is not an identifier.
+  bool ReadIdentifier(std::string* identifier) {
+    SkipWhitespace();
+    if (AtEnd() || !IsIdentifierStart(script_[pos_]))
+      return false;
+    size_t begin = pos_;
+    while (!AtEnd() && IsIdentifierPart(script_[pos_]))
+      ++pos_;
+    *identifier = base::UTF16ToASCII(script_.substr(begin, pos_ - begin));
+    return true;
+  }
+
+  // Advances to the start of the next identifier. Returns false if there are
+  // none left.
+  bool SkipToIdentifier() {
+    while (!AtEnd()) {
+      base::char16 c = script_[pos_];
+      if (IsIdentifierStart(c))
+        return true;
+      if (c >= '0' && c <= '9') {
+        // Skip over numeric literals such as "0x1f" as a whole.
+        while (!AtEnd() && IsIdentifierPart(script_[pos_]))
+          ++pos_;
+        continue;
+      }
+      // Anything else, including non-ASCII characters, is skipped.
+      ++pos_;
+    }
+    return false;
+  }
+
+ private:
+  const base::string16& script_;
+  size_t pos_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScriptScanner);
+};
+
+// Parses the remainder of a FindProxyForURL() definition, starting right
+// after the "FindProxyForURL" identifier, and extracts the name of its first
+// parameter. Handles both "function FindProxyForURL(url, host)" and
+// "FindProxyForURL = function(url, host)". Returns false if the text is
+// something else (for instance a call, or an alias to another function).
+bool ParseUrlParameterName(bool preceded_by_function_keyword,
+                           ScriptScanner* scanner,
+                           std::string* url_param) {
+  if (!preceded_by_function_keyword) {
+    if (!scanner->ConsumeChar('=') && !scanner->ConsumeChar(':'))
+      return false;
+    std::string keyword;
+    if (!scanner->ReadIdentifier(&keyword) || keyword != "function")
+      return false;
+    // Named function expression.
+    std::string ignored_name;
+    scanner->ReadIdentifier(&ignored_name);
+  }
+  if (!scanner->ConsumeChar('('))
+    return false;
+  return scanner->ReadIdentifier(url_param);
+}
+
+}  // namespace
+
+CachingProxyResolver::CachingProxyResolver(ProxyResolver* resolver,
+                                           size_t max_entries,
+                                           base::TimeDelta entry_ttl)
+    : ProxyResolver(resolver->expects_pac_bytes()),
+      resolver_(resolver),
+      entry_ttl_(entry_ttl),
+      tick_clock_(&default_tick_clock_),
+      cache_mode_(CACHE_DISABLED),
+      cache_(max_entries),
+      cache_hits_(0),
+      cache_misses_(0),
+      generation_(0) {
+  DCHECK_GT(max_entries, 0u);
+}
+
+CachingProxyResolver::~CachingProxyResolver() {
+}
+
+// static
+CachingProxyResolver::CacheMode CachingProxyResolver::GetCacheModeForScript(
+    const base::string16& script) {
+  // Number of references to each identifier anywhere in the script.
+  std::map<std::string, int> identifier_counts;
+  // Name of the url parameter of each FindProxyForURL() definition.
+  std::vector<std::string> url_params;
+  bool has_unparsed_definition = false;
+
+  ScriptScanner scanner(script);
+  std::string previous;
+  std::string identifier;
+  while (scanner.SkipToIdentifier()) {
+    scanner.ReadIdentifier(&identifier);
+    identifier_counts[identifier]++;
+
+    if (identifier == "FindProxyForURL") {
+      std::string url_param;
+      if (ParseUrlParameterName(previous == "function", &scanner,
+                                &url_param)) {
+        identifier_counts[url_param]++;
+        url_params.push_back(url_param);
+      } else if (previous == "function") {
+        has_unparsed_definition = true;
+      }
+    }
+    previous.swap(identifier);
+  }
+
+  for (size_t i = 0; i < arraysize(kNonDeterministicIdentifiers); ++i) {
+    if (identifier_counts.count(kNonDeterministicIdentifiers[i]))
+      return CACHE_DISABLED;
+  }
+
+  // "arguments" and "eval" give access to the url without naming it.
+  if (url_params.empty() || has_unparsed_definition ||
+      identifier_counts.count("arguments") || identifier_counts.count("eval")) {
+    return CACHE_PER_URL;
+  }
+
+  // The url parameter may only appear in the parameter lists themselves.
+  std::map<std::string, int> declarations;
+  for (size_t i = 0; i < url_params.size(); ++i)
+    declarations[url_params[i]]++;
+  for (std::map<std::string, int>::const_iterator it = declarations.begin();
+       it != declarations.end(); ++it) {
+    if (identifier_counts[it->first] != it->second)
+      return CACHE_PER_URL;
+  }
+  return CACHE_PER_HOST;
+}
+
+int CachingProxyResolver::GetProxyForURL(const GURL& url,
+                                         ProxyInfo* results,
+                                         const CompletionCallback& callback,
+                                         RequestHandle* request,
+                                         const BoundNetLog& net_log) {
+  DCHECK(CalledOnValidThread());
+
+  std::string key = GetCacheKey(url);
+  if (!key.empty()) {
+    ResultCache::iterator it = cache_.Get(key);
+    if (it != cache_.end()) {
+      if (tick_clock_->NowTicks() < it->second.expiration) {
+        ++cache_hits_;
+        results->Use(it->second.info);
+        return OK;
+      }
+      cache_.Erase(it);
+    }
+    ++cache_misses_;
+  }
+
+  // Synchronous resolvers are invoked with a null callback, so there is
+  // nothing to wrap.
+  CompletionCallback wrapped_callback;
+  if (!callback.is_null()) {
+    wrapped_callback = base::Bind(&CachingProxyResolver::OnRequestComplete,
+                                  base::Unretained(this), generation_, key,
+                                  results, callback);
+  }
+
+  int rv = resolver_->GetProxyForURL(url, results, wrapped_callback, request,
+                                     net_log);
+  if (rv == OK && !key.empty())
+    AddEntry(key, *results);
+  return rv;
+}
+
+void CachingProxyResolver::CancelRequest(RequestHandle request) {
+  DCHECK(CalledOnValidThread());
+  resolver_->CancelRequest(request);
+}
+
+LoadState CachingProxyResolver::GetLoadState(RequestHandle request) const {
+  DCHECK(CalledOnValidThread());
+  return resolver_->GetLoadState(request);
+}
+
+void CachingProxyResolver::CancelSetPacScript() {
+  DCHECK(CalledOnValidThread());
+  cache_mode_ = CACHE_DISABLED;
+  resolver_->CancelSetPacScript();
+}
+
+int CachingProxyResolver::SetPacScript(
+    const scoped_refptr<ProxyResolverScriptData>& script_data,
+    const CompletionCallback& callback) {
+  DCHECK(CalledOnValidThread());
+
+  ++generation_;
+  cache_.Clear();
+  cache_mode_ = CACHE_DISABLED;
+  if (script_data->type() == ProxyResolverScriptData::TYPE_SCRIPT_CONTENTS)
+    cache_mode_ = GetCacheModeForScript(script_data->utf16());
+
+  return resolver_->SetPacScript(script_data, callback);
+}
+
+std::string CachingProxyResolver::GetCacheKey(const GURL& url) const {
+  switch (cache_mode_) {
+    case CACHE_DISABLED:
+      return std::string();
+    case CACHE_PER_URL:
+      return url.spec();
+    case CACHE_PER_HOST:
+      // FindProxyForURL() is passed GURL::HostNoBrackets() as its |host|.
+      return url.HostNoBrackets();
+  }
+  NOTREACHED();
+  return std::string();
+}
+
+void CachingProxyResolver::AddEntry(const std::string& key,
+                                    const ProxyInfo& results) {
+  Entry entry;
+  entry.info.Use(results);
+  entry.expiration = tick_clock_->NowTicks() + entry_ttl_;
+  cache_.Put(key, entry);
+}
+
+void CachingProxyResolver::OnRequestComplete(
+    int generation,
+    const std::string& key,
+    ProxyInfo* results,
+    const CompletionCallback& callback,
+    int result) {
+  DCHECK(CalledOnValidThread());
+  if (result == OK && !key.empty() && generation == generation_)
+    AddEntry(key, *results);
+  callback.Run(result);
+}
+
+}  // namespace net
@@ -0,0 +1,127 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_PROXY_CACHING_PROXY_RESOLVER_H_
+#define NET_PROXY_CACHING_PROXY_RESOLVER_H_
+
+#include <string>
+
+#include "base/containers/mru_cache.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/threading/non_thread_safe.h"
+#include "base/time/default_tick_clock.h"
+#include "base/time/time.h"
+#include "net/base/net_export.h"
+#include "net/proxy/proxy_info.h"
+#include "net/proxy/proxy_resolver.h"
+
+namespace net {
+
+// CachingProxyResolver is a ProxyResolver decorator which remembers the
+// results of FindProxyForURL() so that repeated queries don't have to run the
+// PAC script again. This matters for enterprise PAC scripts which do heavy
+// regular expression matching or dnsResolve() calls for every request.
+//
+// Caching is conservative:
+//
+//   (a) Nothing is cached unless the script contents are known, and the
+//       script does not reference any of the time-dependent or
+//       non-deterministic PAC functions (timeRange(), dateRange(),
+//       weekdayRange(), Date, Math.random()).
+//
+//   (b) If FindProxyForURL() never references its |url| parameter, the
+//       result depends only on the host, so results are cached per host.
+//       Otherwise they are cached per URL.
+//
+//   (c) Entries expire after |entry_ttl|, to bound the staleness of results
+//       which depend on dnsResolve() or myIpAddress().
+//
+// The whole cache is dropped whenever a new PAC script is set (which also
+// happens on network changes).
+class NET_EXPORT_PRIVATE CachingProxyResolver
+    : public ProxyResolver,
+      NON_EXPORTED_BASE(public base::NonThreadSafe) {
+ public:
+  // How results for a given script are keyed, if they are cached at all.
+  enum CacheMode {
+    CACHE_DISABLED,
+    CACHE_PER_URL,
+    CACHE_PER_HOST,
+  };
+
+  // Takes ownership of |resolver|, to which all cache misses are forwarded.
+  // At most |max_entries| results are kept, each for at most |entry_ttl|.
+  CachingProxyResolver(ProxyResolver* resolver,
+                       size_t max_entries,
+                       base::TimeDelta entry_ttl);
+  ~CachingProxyResolver() override;
+
+  // Inspects the text of a PAC script and returns how its results may be
+  // cached.
+  static CacheMode GetCacheModeForScript(const base::string16& script);
+
+  // ProxyResolver implementation:
+  int GetProxyForURL(const GURL& url,
+                     ProxyInfo* results,
+                     const CompletionCallback& callback,
+                     RequestHandle* request,
+                     const BoundNetLog& net_log) override;
+  void CancelRequest(RequestHandle request) override;
+  LoadState GetLoadState(RequestHandle request) const override;
+  void CancelSetPacScript() override;
+  int SetPacScript(const scoped_refptr<ProxyResolverScriptData>& script_data,
+                   const CompletionCallback& callback) override;
+
+  CacheMode cache_mode() const { return cache_mode_; }
+  size_t cache_size() const { return cache_.size(); }
+  size_t cache_hits() const { return cache_hits_; }
+  size_t cache_misses() const { return cache_misses_; }
+
+  void set_tick_clock_for_testing(base::TickClock* tick_clock) {
+    tick_clock_ = tick_clock;
+  }
+
+ private:
+  struct Entry {
+    ProxyInfo info;
+    base::TimeTicks expiration;
+  };
+  typedef base::MRUCache<std::string, Entry> ResultCache;
+
+  // Returns the cache key for |url|, or an empty string if results for |url|
+  // must not be cached.
+  std::string GetCacheKey(const GURL& url) const;
+
+  // Stores |results| under |key|.
+  void AddEntry(const std::string& key, const ProxyInfo& results);
+
+  // Completion of an asynchronous request to |resolver_| which missed the
+  // cache. |generation| is the value of |generation_| when it was started.
+  void OnRequestComplete(int generation,
+                         const std::string& key,
+                         ProxyInfo* results,
+                         const CompletionCallback& callback,
+                         int result);
+
+  const scoped_ptr<ProxyResolver> resolver_;
+  const base::TimeDelta entry_ttl_;
+  base::DefaultTickClock default_tick_clock_;
+  base::TickClock* tick_clock_;
+
+  CacheMode cache_mode_;
+  ResultCache cache_;
+
+  size_t cache_hits_;
+  size_t cache_misses_;
+
+  // Incremented on every SetPacScript(), so that requests started against a
+  // previous script never populate the cache.
+  int generation_;
+
+  DISALLOW_COPY_AND_ASSIGN(CachingProxyResolver);
+};
+
+}  // namespace net
+
+#endif  // NET_PROXY_CACHING_PROXY_RESOLVER_H_
@@ -0,0 +1,249 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/proxy/caching_proxy_resolver.h"
+
+#include "base/strings/utf_string_conversions.h"
+#include "base/test/simple_test_tick_clock.h"
+#include "net/base/net_errors.h"
+#include "net/base/net_log.h"
+#include "net/base/test_completion_callback.h"
+#include "net/proxy/mock_proxy_resolver.h"
+#include "net/proxy/proxy_info.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+using base::ASCIIToUTF16;
+
+namespace net {
+
+namespace {
+
+const size_t kMaxEntries = 3;
+
+// A synchronous ProxyResolver which answers every query with a proxy named
+// after the query's host, and counts how many times it was asked.
+class CountingProxyResolver : public ProxyResolver {
+ public:
+  CountingProxyResolver()
+      : ProxyResolver(true /*expects_pac_bytes*/), request_count_(0) {}
+
+  int GetProxyForURL(const GURL& url,
+                     ProxyInfo* results,
+                     const CompletionCallback& callback,
+                     RequestHandle* request,
+                     const BoundNetLog& net_log) override {
+    EXPECT_TRUE(callback.is_null());
+    request_count_++;
+    results->UseNamedProxy(url.host() + ":80");
+    return OK;
+  }
+
+  void CancelRequest(RequestHandle request) override { NOTREACHED(); }
+
+  LoadState GetLoadState(RequestHandle request) const override {
+    NOTREACHED();
+    return LOAD_STATE_IDLE;
+  }
+
+  void CancelSetPacScript() override { NOTREACHED(); }
+
+  int SetPacScript(const scoped_refptr<ProxyResolverScriptData>& script_data,
+                   const CompletionCallback& callback) override {
+    return OK;
+  }
+
+  int request_count() const { return request_count_; }
+
+ private:
+  int request_count_;
+};
+
+int Resolve(ProxyResolver* resolver, const char* url, ProxyInfo* info) {
+  return resolver->GetProxyForURL(GURL(url), info, CompletionCallback(), NULL,
+                                  BoundNetLog());
+}
+
+CachingProxyResolver::CacheMode ModeFor(const char* script) {
+  return CachingProxyResolver::GetCacheModeForScript(ASCIIToUTF16(script));
+}
+
+TEST(CachingProxyResolverTest, CacheModeForScript) {
+  EXPECT_EQ(CachingProxyResolver::CACHE_PER_HOST,
+            ModeFor("function FindProxyForURL(url, host) {\n"
+                    "  if (shExpMatch(host, '*.example.com'))\n"
+                    "    return 'PROXY p:80';\n"
+                    "  return 'DIRECT';\n"
+                    "}"));
+  EXPECT_EQ(CachingProxyResolver::CACHE_PER_HOST,
+            ModeFor("var FindProxyForURL = function(u, h) { return h; }"));
+  EXPECT_EQ(CachingProxyResolver::CACHE_PER_URL,
+            ModeFor("function FindProxyForURL(url, host) {\n"
+                    "  if (url.substring(0, 5) == 'https') return 'DIRECT';\n"
+                    "  return 'PROXY p:80';\n"
+                    "}"));
+  EXPECT_EQ(CachingProxyResolver::CACHE_PER_URL,
+            ModeFor("function FindProxyForURL(url, host) {\n"
+                    "  return arguments[0];\n"
+                    "}"));
+  EXPECT_EQ(CachingProxyResolver::CACHE_PER_URL,
+            ModeFor("function Impl(url, host) { return 'DIRECT'; }\n"
+                    "FindProxyForURL = Impl;"));
+  EXPECT_EQ(CachingProxyResolver::CACHE_DISABLED,
+            ModeFor("function FindProxyForURL(url, host) {\n"
+                    "  if (timeRange(8, 18)) return 'PROXY p:80';\n"
+                    "  return 'DIRECT';\n"
+                    "}"));
+  EXPECT_EQ(CachingProxyResolver::CACHE_DISABLED,
+            ModeFor("function FindProxyForURL(url, host) {\n"
+                    "  return Math.random() < 0.5 ? 'PROXY a:80' : 'DIRECT';\n"
+                    "}"));
+}
+
+TEST(CachingProxyResolverTest, PerHostCache) {
+  CountingProxyResolver* inner = new CountingProxyResolver;
+  CachingProxyResolver resolver(inner, kMaxEntries,
+                                base::TimeDelta::FromMinutes(1));
+  EXPECT_EQ(OK, resolver.SetPacScript(
+      ProxyResolverScriptData::FromUTF8(
+          "function FindProxyForURL(url, host) { return 'DIRECT'; }"),
+      CompletionCallback()));
+  EXPECT_EQ(CachingProxyResolver::CACHE_PER_HOST, resolver.cache_mode());
+
+  ProxyInfo info;
+  EXPECT_EQ(OK, Resolve(&resolver, "http://a.com/x", &info));
+  EXPECT_EQ("PROXY a.com:80", info.ToPacString());
+  EXPECT_EQ(OK, Resolve(&resolver, "http://a.com/y", &info));
+  EXPECT_EQ("PROXY a.com:80", info.ToPacString());
+  EXPECT_EQ(OK, Resolve(&resolver, "https://a.com/", &info));
+  EXPECT_EQ(OK, Resolve(&resolver, "http://b.com/", &info));
+  EXPECT_EQ("PROXY b.com:80", info.ToPacString());
+
+  EXPECT_EQ(2, inner->request_count());
+  EXPECT_EQ(2u, resolver.cache_hits());
+  EXPECT_EQ(2u, resolver.cache_misses());
+
+  // Setting a new script drops the cache.
+  EXPECT_EQ(OK, resolver.SetPacScript(
+      ProxyResolverScriptData::FromUTF8(
+          "function FindProxyForURL(url, host) { return 'DIRECT'; }"),
+      CompletionCallback()));
+  EXPECT_EQ(0u, resolver.cache_size());
+  EXPECT_EQ(OK, Resolve(&resolver, "http://a.com/x", &info));
+  EXPECT_EQ(3, inner->request_count());
+}
+
+TEST(CachingProxyResolverTest, PerUrlCache) {
+  CountingProxyResolver* inner = new CountingProxyResolver;
+  CachingProxyResolver resolver(inner, kMaxEntries,
+                                base::TimeDelta::FromMinutes(1));
+  EXPECT_EQ(OK, resolver.SetPacScript(
+      ProxyResolverScriptData::FromUTF8(
+          "function FindProxyForURL(url, host) { return url; }"),
+      CompletionCallback()));
+  EXPECT_EQ(CachingProxyResolver::CACHE_PER_URL, resolver.cache_mode());
+
+  ProxyInfo info;
+  EXPECT_EQ(OK, Resolve(&resolver, "http://a.com/x", &info));
+  EXPECT_EQ(OK, Resolve(&resolver, "http://a.com/y", &info));
+  EXPECT_EQ(OK, Resolve(&resolver, "http://a.com/x", &info));
+  EXPECT_EQ(2, inner->request_count());
+  EXPECT_EQ(1u, resolver.cache_hits());
+}
+
+TEST(CachingProxyResolverTest, Disabled) {
+  CountingProxyResolver* inner = new CountingProxyResolver;
+  CachingProxyResolver resolver(inner, kMaxEntries,
+                                base::TimeDelta::FromMinutes(1));
+  // Only the URL of the script is known.
+  EXPECT_EQ(OK, resolver.SetPacScript(
+      ProxyResolverScriptData::FromURL(GURL("http://wpad/wpad.dat")),
+      CompletionCallback()));
+  EXPECT_EQ(CachingProxyResolver::CACHE_DISABLED, resolver.cache_mode());
+
+  ProxyInfo info;
+  EXPECT_EQ(OK, Resolve(&resolver, "http://a.com/x", &info));
+  EXPECT_EQ(OK, Resolve(&resolver, "http://a.com/x", &info));
+  EXPECT_EQ(2, inner->request_count());
+  EXPECT_EQ(0u, resolver.cache_size());
+}
+
+TEST(CachingProxyResolverTest, ExpirationAndEviction) {
+  base::SimpleTestTickClock clock;
+  CountingProxyResolver* inner = new CountingProxyResolver;
+  CachingProxyResolver resolver(inner, kMaxEntries,
+                                base::TimeDelta::FromSeconds(10));
+  resolver.set_tick_clock_for_testing(&clock);
+  EXPECT_EQ(OK, resolver.SetPacScript(
+      ProxyResolverScriptData::FromUTF8(
+          "function FindProxyForURL(url, host) { return 'DIRECT'; }"),
+      CompletionCallback()));
+
+  ProxyInfo info;
+  EXPECT_EQ(OK, Resolve(&resolver, "http://a.com/", &info));
+  clock.Advance(base::TimeDelta::FromSeconds(9));
+  EXPECT_EQ(OK, Resolve(&resolver, "http://a.com/", &info));
+  EXPECT_EQ(1, inner->request_count());
+  clock.Advance(base::TimeDelta::FromSeconds(1));
+  EXPECT_EQ(OK, Resolve(&resolver, "http://a.com/", &info));
+  EXPECT_EQ(2, inner->request_count());
+
+  // Filling the cache evicts the least recently used host.
+  EXPECT_EQ(OK, Resolve(&resolver, "http://b.com/", &info));
+  EXPECT_EQ(OK, Resolve(&resolver, "http://c.com/", &info));
+  EXPECT_EQ(OK, Resolve(&resolver, "http://d.com/", &info));
+  EXPECT_EQ(kMaxEntries, resolver.cache_size());
+  EXPECT_EQ(OK, Resolve(&resolver, "http://a.com/", &info));
+  EXPECT_EQ(6, inner->request_count());
+}
+
+TEST(CachingProxyResolverTest, AsyncResolver) {
+  MockAsyncProxyResolverExpectsBytes* inner =
+      new MockAsyncProxyResolverExpectsBytes;
+  CachingProxyResolver resolver(inner, kMaxEntries,
+                                base::TimeDelta::FromMinutes(1));
+
+  TestCompletionCallback set_script_callback;
+  EXPECT_EQ(ERR_IO_PENDING, resolver.SetPacScript(
+      ProxyResolverScriptData::FromUTF8(
+          "function FindProxyForURL(url, host) { return 'DIRECT'; }"),
+      set_script_callback.callback()));
+  inner->pending_set_pac_script_request()->CompleteNow(OK);
+  EXPECT_EQ(OK, set_script_callback.WaitForResult());
+
+  // A failed request is not cached.
+  ProxyInfo info1;
+  TestCompletionCallback callback1;
+  EXPECT_EQ(ERR_IO_PENDING,
+            resolver.GetProxyForURL(GURL("http://a.com/"), &info1,
+                                    callback1.callback(), NULL, BoundNetLog()));
+  ASSERT_EQ(1u, inner->pending_requests().size());
+  inner->pending_requests()[0]->CompleteNow(ERR_FAILED);
+  EXPECT_EQ(ERR_FAILED, callback1.WaitForResult());
+  EXPECT_EQ(0u, resolver.cache_size());
+
+  ProxyInfo info2;
+  TestCompletionCallback callback2;
+  EXPECT_EQ(ERR_IO_PENDING,
+            resolver.GetProxyForURL(GURL("http://a.com/"), &info2,
+                                    callback2.callback(), NULL, BoundNetLog()));
+  ASSERT_EQ(1u, inner->pending_requests().size());
+  inner->pending_requests()[0]->results()->UseNamedProxy("p:80");
+  inner->pending_requests()[0]->CompleteNow(OK);
+  EXPECT_EQ(OK, callback2.WaitForResult());
+  EXPECT_EQ(1u, resolver.cache_size());
+
+  // The next request for the host completes synchronously from the cache.
+  ProxyInfo info3;
+  TestCompletionCallback callback3;
+  EXPECT_EQ(OK,
+            resolver.GetProxyForURL(GURL("http://a.com/other"), &info3,
+                                    callback3.callback(), NULL, BoundNetLog()));
+  EXPECT_EQ("PROXY p:80", info3.ToPacString());
+  EXPECT_EQ(0u, inner->pending_requests().size());
+}
+
+}  // namespace
+
+}  // namespace net
@@ -8,12 +8,15 @@
 #include "base/path_service.h"
 #include "base/strings/string_util.h"
 #include "base/test/perf_time_logger.h"
+#include "base/time/time.h"
 #include "net/base/net_errors.h"
 #include "net/dns/mock_host_resolver.h"
+#include "net/proxy/caching_proxy_resolver.h"
 #include "net/proxy/proxy_info.h"
 #include "net/proxy/proxy_resolver_v8.h"
 #include "net/test/spawned_test_server/spawned_test_server.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
 
 #if defined(OS_WIN)
 #include "net/proxy/proxy_resolver_winhttp.h"
@@ -131,6 +134,7 @@ class PacPerfSuiteRunner {
     // Start the perf timer.
     std::string perf_test_name = resolver_name_ + "_" + script_name;
     base::PerfTimeLogger timer(perf_test_name.c_str());
+    base::TimeTicks start_time = base::TimeTicks::Now();
 
     for (int i = 0; i < kNumIterations; ++i) {
       // Round-robin between URLs to resolve.
@@ -148,8 +152,12 @@ class PacPerfSuiteRunner {
       ASSERT_EQ(query.expected_result, proxy_info.ToPacString());
     }
 
-    // Print how long the test ran for.
+    // Print how long the test ran for, and the resulting throughput.
+    base::TimeDelta elapsed = base::TimeTicks::Now() - start_time;
     timer.Done();
+    perf_test::PrintResult("urls_per_second", "", perf_test_name,
+                           kNumIterations / elapsed.InSecondsF(), "urls/s",
+                           true);
   }
 
   // Read the PAC script from disk and initialize the proxy resolver with it.
@@ -223,3 +231,15 @@ TEST(ProxyResolverPerfTest, ProxyResolverV8) {
   PacPerfSuiteRunner runner(&resolver, "ProxyResolverV8");
   runner.RunAllTests();
 }
+
+TEST(ProxyResolverPerfTest, ProxyResolverV8WithResultCache) {
+  net::ProxyResolverV8::EnsureIsolateCreated();
+
+  MockJSBindings js_bindings;
+  net::ProxyResolverV8* v8_resolver = new net::ProxyResolverV8;
+  v8_resolver->set_js_bindings(&js_bindings);
+  net::CachingProxyResolver resolver(v8_resolver, 1000,
+                                     base::TimeDelta::FromMinutes(5));
+  PacPerfSuiteRunner runner(&resolver, "ProxyResolverV8WithResultCache");
+  runner.RunAllTests();
+}
@@ -5,6 +5,7 @@
 #include "net/proxy/proxy_service_v8.h"
 
 #include "base/logging.h"
+#include "net/proxy/caching_proxy_resolver.h"
 #include "net/proxy/network_delegate_error_observer.h"
 #include "net/proxy/proxy_resolver.h"
 #include "net/proxy/proxy_resolver_v8_tracing.h"
@@ -12,6 +13,15 @@
 
 namespace net {
 
+namespace {
+
+// Limits for the cache of FindProxyForURL() results. The lifetime matches the
+// default HostCache TTL, since cached results may depend on dnsResolve().
+const size_t kMaxCachedProxyResults = 1000;
+const int kCachedProxyResultTtlSeconds = 60;
+
+}  // namespace
+
 // static
 ProxyService* CreateProxyServiceUsingV8ProxyResolver(
     ProxyConfigService* proxy_config_service,
@@ -28,8 +38,10 @@ ProxyService* CreateProxyServiceUsingV8ProxyResolver(
   ProxyResolverErrorObserver* error_observer = new NetworkDelegateErrorObserver(
       network_delegate, base::MessageLoopProxy::current().get());
 
-  ProxyResolver* proxy_resolver =
-      new ProxyResolverV8Tracing(host_resolver, error_observer, net_log);
+  ProxyResolver* proxy_resolver = new CachingProxyResolver(
+      new ProxyResolverV8Tracing(host_resolver, error_observer, net_log),
+      kMaxCachedProxyResults,
+      base::TimeDelta::FromSeconds(kCachedProxyResultTtlSeconds));
 
   ProxyService* proxy_service =
       new ProxyService(proxy_config_service, proxy_resolver, net_log);
@@ -113,9 +113,19 @@ bool HttpConnection::QueuedWriteIOBuffer::Append(const std::string& data) {
     return false;
   }
 
-  pending_data_.push(data);
   total_size_ += data.size();
 
+  // Coalesce small chunks queued behind the one being written, so that many
+  // small messages don't each cost a separate write. The front chunk is never
+  // modified, since data() points into it.
+  if (pending_data_.size() > 1 &&
+      pending_data_.back().size() + data.size() <= kMaxCoalescedSize) {
+    pending_data_.back().append(data);
+    return true;
+  }
+
+  pending_data_.push(data);
+
   // If new data is the first pending data, updates data_.
   if (pending_data_.size() == 1)
     data_ = const_cast<char*>(pending_data_.front().data());
@@ -73,6 +73,8 @@ class HttpConnection {
   class QueuedWriteIOBuffer : public IOBuffer {
    public:
     static const int kDefaultMaxBufferSize = 1 * 1024 * 1024;  // 1 Mbytes.
+    // Chunks queued behind the first one are merged up to this size.
+    static const size_t kMaxCoalescedSize = 16 * 1024;
 
     QueuedWriteIOBuffer();
 
@@ -81,7 +83,9 @@ class HttpConnection {
 
     // Appends new pending data and returns true if total size doesn't exceed
     // the limit, |total_size_limit_|.  It would change data() if new data is
-    // the first pending data.
+    // the first pending data.  Small data may be merged into the previous
+    // pending data unless that is the first one, so a later GetSizeToWrite()
+    // can span several appends.
     bool Append(const std::string& data);
 
     // Consumes data and changes data() accordingly.  It cannot be more than
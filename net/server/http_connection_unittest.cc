@@ -287,6 +287,41 @@ TEST(HttpConnectionTest, QueuedWriteIOBuffer_Append_DidConsume) {
   EXPECT_EQ(0, buffer->total_size());
 }
 
+TEST(HttpConnectionTest, QueuedWriteIOBuffer_CoalescesSmallData) {
+  scoped_refptr<HttpConnection::QueuedWriteIOBuffer> buffer(
+      new HttpConnection::QueuedWriteIOBuffer());
+
+  const std::string kData("first");
+  const std::string kData2("second");
+  const std::string kData3("third");
+  EXPECT_TRUE(buffer->Append(kData));
+  EXPECT_TRUE(buffer->Append(kData2));
+  EXPECT_TRUE(buffer->Append(kData3));
+  EXPECT_EQ(static_cast<int>(kData.size() + kData2.size() + kData3.size()),
+            buffer->total_size());
+
+  // The first data is written on its own, since it may be in flight.
+  EXPECT_EQ(kData, base::StringPiece(buffer->data(), buffer->GetSizeToWrite()));
+  buffer->DidConsume(kData.size());
+
+  // The data appended behind it was merged into a single write.
+  EXPECT_EQ(kData2 + kData3,
+            base::StringPiece(buffer->data(), buffer->GetSizeToWrite()));
+  buffer->DidConsume(kData2.size() + kData3.size());
+  EXPECT_TRUE(buffer->IsEmpty());
+
+  // Large data is never merged.
+  const std::string kLargeData(
+      HttpConnection::QueuedWriteIOBuffer::kMaxCoalescedSize, 'd');
+  EXPECT_TRUE(buffer->Append(kData));
+  EXPECT_TRUE(buffer->Append(kData2));
+  EXPECT_TRUE(buffer->Append(kLargeData));
+  buffer->DidConsume(kData.size());
+  EXPECT_EQ(static_cast<int>(kData2.size()), buffer->GetSizeToWrite());
+  buffer->DidConsume(kData2.size());
+  EXPECT_EQ(static_cast<int>(kLargeData.size()), buffer->GetSizeToWrite());
+}
+
 TEST(HttpConnectionTest, QueuedWriteIOBuffer_TotalSizeLimit) {
   scoped_refptr<HttpConnection::QueuedWriteIOBuffer> buffer(
       new HttpConnection::QueuedWriteIOBuffer());
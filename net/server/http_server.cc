@@ -4,6 +4,8 @@
 
 #include "net/server/http_server.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/compiler_specific.h"
 #include "base/location.h"
@@ -11,6 +13,7 @@
 #include "base/message_loop/message_loop_proxy.h"
 #include "base/stl_util.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/strings/string_piece.h"
 #include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
 #include "base/sys_byteorder.h"
@@ -85,8 +88,11 @@ void HttpServer::Send(int connection_id,
                       const std::string& content_type) {
   HttpServerResponseInfo response(status_code);
   response.SetContentHeaders(data.size(), content_type);
-  SendResponse(connection_id, response);
-  SendRaw(connection_id, data);
+  // Queue the headers and body as a single chunk, so that small responses go
+  // out with one write.
+  std::string raw_response = response.Serialize();
+  raw_response.append(data);
+  SendRaw(connection_id, raw_response);
 }
 
 void HttpServer::Send200(int connection_id,
@@ -382,9 +388,22 @@ bool HttpServer::ParseHeaders(const char* data,
                               size_t data_len,
                               HttpServerRequestInfo* info,
                               size_t* ppos) {
+  // Headers are only complete once the empty line that ends them has been
+  // received. Every accepted terminator contains "\n\r\n", so bail out early
+  // instead of running the state machine over a partial request again on
+  // each read.
+  const char kTerminator[] = "\n\r\n";
+  if (std::search(data + *ppos, data + data_len, kTerminator,
+                  kTerminator + arraysize(kTerminator) - 1) ==
+      data + data_len) {
+    return false;
+  }
+
   size_t& pos = *ppos;
   int state = ST_METHOD;
-  std::string buffer;
+  // Tokens are not copied character by character. Instead, |token_start| is
+  // the offset in |data| at which the token of the current state begins.
+  size_t token_start = pos;
   std::string header_name;
   std::string header_value;
   while (pos < data_len) {
@@ -395,27 +414,26 @@ bool HttpServer::ParseHeaders(const char* data,
     bool transition = (next_state != state);
     HttpServerRequestInfo::HeadersMap::iterator it;
     if (transition) {
+      // The token excludes the character which caused the transition.
+      base::StringPiece token(data + token_start, pos - 1 - token_start);
       // Do any actions based on state transitions.
       switch (state) {
         case ST_METHOD:
-          info->method = buffer;
-          buffer.clear();
+          token.CopyToString(&info->method);
           break;
         case ST_URL:
-          info->path = buffer;
-          buffer.clear();
+          token.CopyToString(&info->path);
           break;
         case ST_PROTO:
           // TODO(mbelshe): Deal better with parsing protocol.
-          DCHECK(buffer == "HTTP/1.1");
-          buffer.clear();
+          DCHECK(token == "HTTP/1.1");
           break;
         case ST_NAME:
-          header_name = base::StringToLowerASCII(buffer);
-          buffer.clear();
+          header_name = base::StringToLowerASCII(token.as_string());
           break;
         case ST_VALUE:
-          base::TrimWhitespaceASCII(buffer, base::TRIM_LEADING, &header_value);
+          base::TrimWhitespaceASCII(token.as_string(), base::TRIM_LEADING,
+                                    &header_value);
           it = info->headers.find(header_name);
           // See last paragraph ("Multiple message-header fields...")
           // of www.w3.org/Protocols/rfc2616/rfc2616-sec4.html#sec4.2
@@ -425,22 +443,15 @@ bool HttpServer::ParseHeaders(const char* data,
             it->second.append(",");
             it->second.append(header_value);
           }
-          buffer.clear();
           break;
         case ST_SEPARATOR:
           break;
       }
       state = next_state;
+      token_start = pos;
     } else {
       // Do any actions based on current state
       switch (state) {
-        case ST_METHOD:
-        case ST_URL:
-        case ST_PROTO:
-        case ST_VALUE:
-        case ST_NAME:
-          buffer.append(&ch, 1);
-          break;
         case ST_DONE:
           DCHECK(input == INPUT_LF);
           return true;
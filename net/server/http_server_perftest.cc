@@ -0,0 +1,224 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/server/http_server.h"
+
+#include <string>
+
+#include "base/bind.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
+#include "base/message_loop/message_loop.h"
+#include "base/run_loop.h"
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
+#include "net/base/address_list.h"
+#include "net/base/io_buffer.h"
+#include "net/base/ip_endpoint.h"
+#include "net/base/net_errors.h"
+#include "net/base/net_log.h"
+#include "net/server/http_server_request_info.h"
+#include "net/server/http_server_response_info.h"
+#include "net/socket/tcp_client_socket.h"
+#include "net/socket/tcp_server_socket.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace net {
+
+namespace {
+
+const int kNumConnections = 16;
+const int kRequestsPerConnection = 500;
+const char kContentType[] = "text/plain";
+
+// A keep-alive client which issues |num_requests| GET requests back to back,
+// in the style of wrk, and runs |done_callback| when the last response has
+// been received.
+class LoadClient {
+ public:
+  LoadClient(const IPEndPoint& address,
+             int num_requests,
+             int response_size,
+             const base::Closure& done_callback)
+      : socket_(new TCPClientSocket(AddressList(address), NULL,
+                                    NetLog::Source())),
+        request_("GET /index.html HTTP/1.1\r\nHost: localhost\r\n\r\n"),
+        requests_left_(num_requests),
+        response_size_(response_size),
+        bytes_left_(0),
+        read_buffer_(new IOBufferWithSize(32 * 1024)),
+        done_callback_(done_callback) {}
+
+  void Start() {
+    int rv = socket_->Connect(
+        base::Bind(&LoadClient::OnConnected, base::Unretained(this)));
+    if (rv != ERR_IO_PENDING)
+      OnConnected(rv);
+  }
+
+ private:
+  void OnConnected(int rv) {
+    ASSERT_EQ(OK, rv);
+    SendRequest();
+  }
+
+  void SendRequest() {
+    bytes_left_ = response_size_;
+    write_buffer_ = new DrainableIOBuffer(new StringIOBuffer(request_),
+                                          request_.size());
+    Write();
+    Read();
+  }
+
+  void Write() {
+    int rv = socket_->Write(
+        write_buffer_.get(), write_buffer_->BytesRemaining(),
+        base::Bind(&LoadClient::OnWritten, base::Unretained(this)));
+    if (rv != ERR_IO_PENDING)
+      OnWritten(rv);
+  }
+
+  void OnWritten(int rv) {
+    ASSERT_GT(rv, 0);
+    write_buffer_->DidConsume(rv);
+    if (write_buffer_->BytesRemaining())
+      Write();
+  }
+
+  void Read() {
+    int rv;
+    do {
+      rv = socket_->Read(
+          read_buffer_.get(), read_buffer_->size(),
+          base::Bind(&LoadClient::OnRead, base::Unretained(this)));
+      if (rv == ERR_IO_PENDING)
+        return;
+    } while (HandleRead(rv));
+  }
+
+  void OnRead(int rv) {
+    if (HandleRead(rv))
+      Read();
+  }
+
+  // Returns true if more data should be read for the current response.
+  bool HandleRead(int rv) {
+    EXPECT_GT(rv, 0);
+    if (rv <= 0) {
+      done_callback_.Run();
+      return false;
+    }
+    bytes_left_ -= rv;
+    EXPECT_GE(bytes_left_, 0);
+    if (bytes_left_ > 0)
+      return true;
+
+    if (--requests_left_ == 0) {
+      done_callback_.Run();
+      return false;
+    }
+    SendRequest();
+    return false;
+  }
+
+  scoped_ptr<TCPClientSocket> socket_;
+  const std::string request_;
+  int requests_left_;
+  const int response_size_;
+  int bytes_left_;
+  scoped_refptr<IOBufferWithSize> read_buffer_;
+  scoped_refptr<DrainableIOBuffer> write_buffer_;
+  base::Closure done_callback_;
+
+  DISALLOW_COPY_AND_ASSIGN(LoadClient);
+};
+
+class HttpServerPerfTest : public testing::Test,
+                           public HttpServer::Delegate {
+ public:
+  HttpServerPerfTest()
+      : message_loop_(base::MessageLoop::TYPE_IO), clients_left_(0) {}
+
+  void SetUp() override {
+    scoped_ptr<ServerSocket> server_socket(
+        new TCPServerSocket(NULL, NetLog::Source()));
+    ASSERT_EQ(OK, server_socket->ListenWithAddressAndPort("127.0.0.1", 0,
+                                                          kNumConnections));
+    server_.reset(new HttpServer(server_socket.Pass(), this));
+    ASSERT_EQ(OK, server_->GetLocalAddress(&server_address_));
+  }
+
+  // HttpServer::Delegate implementation:
+  void OnConnect(int connection_id) override {}
+  void OnHttpRequest(int connection_id,
+                     const HttpServerRequestInfo& info) override {
+    server_->Send200(connection_id, body_, kContentType);
+  }
+  void OnWebSocketRequest(int connection_id,
+                          const HttpServerRequestInfo& info) override {
+    NOTREACHED();
+  }
+  void OnWebSocketMessage(int connection_id,
+                          const std::string& data) override {
+    NOTREACHED();
+  }
+  void OnClose(int connection_id) override {}
+
+ protected:
+  void RunLoad(size_t body_size) {
+    body_.assign(body_size, 'x');
+    HttpServerResponseInfo response(HTTP_OK);
+    response.SetContentHeaders(body_.size(), kContentType);
+    int response_size = response.Serialize().size() + body_.size();
+
+    base::RunLoop run_loop;
+    quit_closure_ = run_loop.QuitClosure();
+    clients_left_ = kNumConnections;
+
+    ScopedVector<LoadClient> clients;
+    base::TimeTicks start = base::TimeTicks::Now();
+    for (int i = 0; i < kNumConnections; ++i) {
+      clients.push_back(new LoadClient(
+          server_address_, kRequestsPerConnection, response_size,
+          base::Bind(&HttpServerPerfTest::OnClientDone,
+                     base::Unretained(this))));
+      clients.back()->Start();
+    }
+    run_loop.Run();
+    base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+
+    perf_test::PrintResult(
+        "http_server_requests_per_second",
+        base::StringPrintf("_%db", static_cast<int>(body_size)), "loopback",
+        kNumConnections * kRequestsPerConnection / elapsed.InSecondsF(),
+        "requests/s", true);
+  }
+
+ private:
+  void OnClientDone() {
+    if (--clients_left_ == 0)
+      quit_closure_.Run();
+  }
+
+  base::MessageLoop message_loop_;
+  scoped_ptr<HttpServer> server_;
+  IPEndPoint server_address_;
+  std::string body_;
+  base::Closure quit_closure_;
+  int clients_left_;
+};
+
+TEST_F(HttpServerPerfTest, SmallResponses) {
+  RunLoad(128);
+}
+
+TEST_F(HttpServerPerfTest, LargeResponses) {
+  RunLoad(256 * 1024);
+}
+
+}  // namespace
+
+}  // namespace net
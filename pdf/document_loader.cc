@@ -17,10 +17,18 @@ namespace chrome_pdf {
 // Document below size will be downloaded in one chunk.
 const uint32 kMinFileSize = 64*1024;
 
+// Largest range request issued, in bytes.
+const uint32 kMaxRequestSize = 2*1024*1024;
+
+// Range requests are sized to take about this long at the measured download
+// rate.
+const double kTargetRequestSeconds = 0.5;
+
 DocumentLoader::DocumentLoader(Client* client)
     : client_(client), partial_document_(false), request_pending_(false),
       current_pos_(0), current_chunk_size_(0), current_chunk_read_(0),
-      document_size_(0), header_request_(true), is_multipart_(false) {
+      document_size_(0), header_request_(true), is_multipart_(false),
+      bytes_per_second_(0) {
   loader_factory_.Initialize(this);
 }
 
@@ -90,7 +98,7 @@ bool DocumentLoader::Init(const pp::URLLoader& loader,
     chunk_stream_.Preallocate(content_length);
 
   document_size_ = content_length;
-  requests_count_ = 0;
+  bytes_per_second_ = 0;
 
   // Enable partial loading only if file size is above the threshold.
   // It will allow avoiding latency for multiple requests.
@@ -246,6 +254,23 @@ void DocumentLoader::DownloadPendingRequests() {
     size = new_size;
   }
 
+  // PDFium tends to ask for several nearby blocks in a row, e.g. a
+  // cross-reference section followed by the objects it points at. Fold queued
+  // requests which start within one request size of the current range into
+  // it, so that they are served by the same round trip. They are dropped from
+  // the queue once their data is available.
+  PendingRequests::const_iterator it = pending_requests_.begin();
+  for (++it; it != pending_requests_.end(); ++it) {
+    uint32 request_end = it->first + it->second;
+    if (it->first < pos || it->first > pos + size + cur_request_size ||
+        request_end <= pos + size || request_end - pos > kMaxRequestSize) {
+      continue;
+    }
+    if (IsDataAvailable(it->first, it->second))
+      continue;
+    size = request_end - pos;
+  }
+
   size_t last_byte_before = chunk_stream_.GetLastByteBefore(pos);
   size_t first_byte_after = chunk_stream_.GetFirstByteAfter(pos + size - 1);
   if (pos - last_byte_before < cur_request_size) {
@@ -265,7 +290,7 @@ void DocumentLoader::DownloadPendingRequests() {
   pp::CompletionCallback callback =
       loader_factory_.NewCallback(&DocumentLoader::DidOpen);
   pp::URLRequestInfo request = GetRequest(pos, size);
-  requests_count_++;
+  request_start_time_ = base::TimeTicks::Now();
   int rv = loader_.Open(request, callback);
   if (rv != PP_OK_COMPLETIONPENDING)
     callback.Run(rv);
@@ -467,6 +492,8 @@ void DocumentLoader::ReadComplete() {
     return;
   }
 
+  if (request_pending_)
+    UpdateThroughput();
   request_pending_ = false;
   pending_requests_.pop_front();
 
@@ -503,11 +530,35 @@ void DocumentLoader::ReadComplete() {
 
 uint32 DocumentLoader::GetRequestSize() const {
   // Document loading strategy:
-  // For first 10 requests, we use 32k chunk sizes, for the next 10 requests we
-  // double the size (64k), and so on, until we cap max request size at 2M for
-  // 71 or more requests.
-  uint32 limited_count = std::min(std::max(requests_count_, 10u), 70u);
-  return 32*1024 * (1 << ((limited_count - 1) / 10u));
+  // Start with 32k requests, then size each request so that it takes about
+  // kTargetRequestSeconds at the download rate seen so far, in multiples of
+  // 32k and capped at 2M. On fast connections this quickly moves to large
+  // requests and amortizes the per-request latency, while on slow ones a
+  // request for a block PDFium needs right away is never stuck behind a long
+  // background download.
+  if (bytes_per_second_ <= 0)
+    return kDefaultRequestSize;
+  double size = bytes_per_second_ * kTargetRequestSeconds;
+  if (size >= kMaxRequestSize)
+    return kMaxRequestSize;
+  uint32 chunks = static_cast<uint32>(size) / kDefaultRequestSize;
+  return std::max(chunks, 1u) * kDefaultRequestSize;
+}
+
+void DocumentLoader::UpdateThroughput() {
+  double seconds =
+      (base::TimeTicks::Now() - request_start_time_).InSecondsF();
+  if (seconds <= 0 || current_chunk_read_ == 0)
+    return;
+
+  // The sample includes the request latency, which is what makes small
+  // requests expensive; average it with the previous estimate so that one
+  // slow response does not collapse the request size.
+  double sample = current_chunk_read_ / seconds;
+  if (bytes_per_second_ <= 0)
+    bytes_per_second_ = sample;
+  else
+    bytes_per_second_ = (bytes_per_second_ + sample) / 2;
 }
 
 }  // namespace chrome_pdf
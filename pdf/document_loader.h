@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "base/basictypes.h"
+#include "base/time/time.h"
 #include "pdf/chunk_stream.h"
 #include "ppapi/cpp/url_loader.h"
 #include "ppapi/utility/completion_callback_factory.h"
@@ -97,6 +98,9 @@ class DocumentLoader {
   pp::URLRequestInfo GetRequest(uint32 position, uint32 size) const;
   // Returns current request size in bytes.
   uint32 GetRequestSize() const;
+  // Folds the throughput of the range request which just completed into
+  // |bytes_per_second_|.
+  void UpdateThroughput();
 
   Client* client_;
   std::string url_;
@@ -115,7 +119,11 @@ class DocumentLoader {
   bool header_request_;
   bool is_multipart_;
   std::string multipart_boundary_;
-  uint32 requests_count_;
+  // Start time of the outstanding range request.
+  base::TimeTicks request_start_time_;
+  // Smoothed download rate of range requests, or 0 before the first one has
+  // completed.
+  double bytes_per_second_;
   std::list<std::vector<unsigned char> > chunk_buffer_;
 };
 
@@ -80,6 +80,8 @@
             'pdfium/pdfium_mem_buffer_file_write.h',
             'pdfium/pdfium_page.cc',
             'pdfium/pdfium_page.h',
+            'pdfium/pdfium_page_bitmap_cache.cc',
+            'pdfium/pdfium_page_bitmap_cache.h',
             'pdfium/pdfium_range.cc',
             'pdfium/pdfium_range.h',
           ],
@@ -121,6 +123,21 @@
         }],
       ],
     },
+    {
+      'target_name': 'pdf_unittests',
+      'type': '<(gtest_target_type)',
+      'dependencies': [
+        '../base/base.gyp:base',
+        '../base/base.gyp:run_all_unittests',
+        '../testing/gtest.gyp:gtest',
+        '../third_party/pdfium/pdfium.gyp:pdfium',
+      ],
+      'sources': [
+        'pdfium/pdfium_page_bitmap_cache.cc',
+        'pdfium/pdfium_page_bitmap_cache.h',
+        'pdfium/pdfium_page_bitmap_cache_unittest.cc',
+      ],
+    },
   ],
   'conditions': [
     # CrOS has a separate step to do this.
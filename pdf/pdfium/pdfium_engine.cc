@@ -631,6 +631,7 @@ PDFiumEngine::PDFiumEngine(PDFEngine::Client* client)
 }
 
 PDFiumEngine::~PDFiumEngine() {
+  page_bitmap_cache_.Clear();
   for (size_t i = 0; i < pages_.size(); ++i)
     pages_[i]->Unload();
 
@@ -1073,6 +1074,7 @@ void PDFiumEngine::PostPaint() {
     FPDF_RenderPage_Close(
         pages_[progressive_paints_[i].page_index]->GetPage());
     FPDFBitmap_Destroy(progressive_paints_[i].bitmap);
+    FPDFBitmap_Destroy(progressive_paints_[i].page_bitmap);
     progressive_paints_.erase(progressive_paints_.begin() + i);
     --i;
   }
@@ -2587,6 +2589,7 @@ void PDFiumEngine::ContinueLoadingDocument(
 
 void PDFiumEngine::LoadPageInfo(bool reload) {
   pending_pages_.clear();
+  page_bitmap_cache_.Clear();
   pp::Size old_document_size = document_size_;
   document_size_ = pp::Size();
   std::vector<pp::Rect> page_rects;
@@ -2754,6 +2757,7 @@ int PDFiumEngine::StartPaint(int page_index, const pp::Rect& dirty) {
   progressive.rect = dirty;
   progressive.page_index = page_index;
   progressive.bitmap = NULL;
+  progressive.page_bitmap = NULL;
   progressive.painted_ = false;
   progressive_paints_.push_back(progressive);
   return progressive_paints_.size() - 1;
@@ -2767,12 +2771,26 @@ bool PDFiumEngine::ContinuePaint(int progressive_index,
 
   int rv;
   int page_index = progressive_paints_[progressive_index].page_index;
+  pp::Rect dirty = progressive_paints_[progressive_index].rect;
   last_progressive_start_time_ = base::Time::Now();
-  if (progressive_paints_[progressive_index].bitmap) {
+  if (progressive_paints_[progressive_index].bitmap ||
+      progressive_paints_[progressive_index].page_bitmap) {
     rv = FPDF_RenderPage_Continue(
         pages_[page_index]->GetPage(), static_cast<IFSDK_PAUSE*>(this));
+  } else if (GetCachedPageBitmap(page_index)) {
+    rv = FPDF_RENDER_DONE;
+  } else if (ShouldCachePageBitmap(page_index, dirty)) {
+    pp::Rect page_rect = GetPageBitmapRect(page_index);
+    FPDF_BITMAP page_bitmap =
+        FPDFBitmap_Create(page_rect.width(), page_rect.height(), 0);
+    progressive_paints_[progressive_index].page_bitmap = page_bitmap;
+    FPDFBitmap_FillRect(page_bitmap, 0, 0, page_rect.width(),
+                        page_rect.height(), 0xFFFFFFFF);
+    rv = FPDF_RenderPageBitmap_Start(
+        page_bitmap, pages_[page_index]->GetPage(), 0, 0, page_rect.width(),
+        page_rect.height(), current_rotation_, GetRenderingFlags(),
+        static_cast<IFSDK_PAUSE*>(this));
   } else {
-    pp::Rect dirty = progressive_paints_[progressive_index].rect;
     progressive_paints_[progressive_index].bitmap = CreateBitmap(dirty,
                                                                  image_data);
     int start_x, start_y, size_x, size_y;
@@ -2786,7 +2804,46 @@ bool PDFiumEngine::ContinuePaint(int progressive_index,
         current_rotation_,
         GetRenderingFlags(), static_cast<IFSDK_PAUSE*>(this));
   }
-  return rv != FPDF_RENDER_TOBECOUNTINUED;
+  if (rv == FPDF_RENDER_TOBECOUNTINUED)
+    return false;
+
+  if (progressive_paints_[progressive_index].page_bitmap) {
+    page_bitmap_cache_.Put(page_index, GetPageBitmapParams(page_index),
+                           progressive_paints_[progressive_index].page_bitmap,
+                           visible_pages_);
+    progressive_paints_[progressive_index].page_bitmap = NULL;
+  }
+
+  if (!progressive_paints_[progressive_index].bitmap) {
+    // The page was rendered whole, copy the dirty part of it into the plugin
+    // image.
+    FPDF_BITMAP bitmap = CreateBitmap(dirty, image_data);
+    progressive_paints_[progressive_index].bitmap = bitmap;
+    FPDF_BITMAP page_bitmap = GetCachedPageBitmap(page_index);
+    // Both rects are in document pixels, so scrolling only moves |dirty|.
+    pp::Rect page_rect = GetPageBitmapRect(page_index);
+    pp::Rect dirty_in_document = dirty;
+    dirty_in_document.Offset(position_);
+    pp::Rect copy_rect = page_rect.Intersect(dirty_in_document);
+    if (bitmap && page_bitmap && !copy_rect.IsEmpty()) {
+      const int kBytesPerPixel = 4;
+      int src_stride = FPDFBitmap_GetStride(page_bitmap);
+      int dest_stride = FPDFBitmap_GetStride(bitmap);
+      const uint8* src = static_cast<const uint8*>(
+          FPDFBitmap_GetBuffer(page_bitmap)) +
+          (copy_rect.y() - page_rect.y()) * src_stride +
+          (copy_rect.x() - page_rect.x()) * kBytesPerPixel;
+      uint8* dest = static_cast<uint8*>(FPDFBitmap_GetBuffer(bitmap)) +
+          (copy_rect.y() - dirty_in_document.y()) * dest_stride +
+          (copy_rect.x() - dirty_in_document.x()) * kBytesPerPixel;
+      for (int y = 0; y < copy_rect.height(); ++y) {
+        memcpy(dest, src, copy_rect.width() * kBytesPerPixel);
+        src += src_stride;
+        dest += dest_stride;
+      }
+    }
+  }
+  return true;
 }
 
 void PDFiumEngine::FinishPaint(int progressive_index,
@@ -2821,10 +2878,50 @@ void PDFiumEngine::CancelPaints() {
   for (size_t i = 0; i < progressive_paints_.size(); ++i) {
     FPDF_RenderPage_Close(pages_[progressive_paints_[i].page_index]->GetPage());
     FPDFBitmap_Destroy(progressive_paints_[i].bitmap);
+    FPDFBitmap_Destroy(progressive_paints_[i].page_bitmap);
   }
   progressive_paints_.clear();
 }
 
+bool PDFiumEngine::ShouldCachePageBitmap(int page_index,
+                                         const pp::Rect& dirty) const {
+  if (!PDFiumPageBitmapCache::CanCache(GetPageBitmapParams(page_index)))
+    return false;
+
+  // Rendering the whole page costs more than rendering a thin strip of it, so
+  // only do it when most of the page is being painted anyway, e.g. after a
+  // zoom or on first display. Later scrolls then only copy from the cache.
+  pp::Rect page_rect = GetScreenRect(pages_[page_index]->rect());
+  int64 page_pixels =
+      static_cast<int64>(page_rect.width()) * page_rect.height();
+  pp::Rect dirty_in_page = page_rect.Intersect(dirty);
+  int64 dirty_pixels =
+      static_cast<int64>(dirty_in_page.width()) * dirty_in_page.height();
+  return dirty_pixels * 2 >= page_pixels;
+}
+
+FPDF_BITMAP PDFiumEngine::GetCachedPageBitmap(int page_index) const {
+  return page_bitmap_cache_.Get(page_index, GetPageBitmapParams(page_index));
+}
+
+pp::Rect PDFiumEngine::GetPageBitmapRect(int page_index) const {
+  // Like GetScreenRect(), but without the scroll position, so that the size
+  // doesn't change by a pixel as the page scrolls.
+  const pp::Rect& rect = pages_[page_index]->rect();
+  int x = static_cast<int>(rect.x() * current_zoom_);
+  int y = static_cast<int>(rect.y() * current_zoom_);
+  int right = static_cast<int>(ceil(rect.right() * current_zoom_));
+  int bottom = static_cast<int>(ceil(rect.bottom() * current_zoom_));
+  return pp::Rect(x, y, right - x, bottom - y);
+}
+
+PDFiumPageBitmapCache::Params PDFiumEngine::GetPageBitmapParams(
+    int page_index) const {
+  return PDFiumPageBitmapCache::Params(
+      GetPageBitmapRect(page_index).size(), current_zoom_, current_rotation_,
+      GetRenderingFlags());
+}
+
 void PDFiumEngine::FillPageSides(int progressive_index) {
   int page_index = progressive_paints_[progressive_index].page_index;
   pp::Rect dirty_in_screen = progressive_paints_[progressive_index].rect;
@@ -15,6 +15,7 @@
 #include "pdf/document_loader.h"
 #include "pdf/pdf_engine.h"
 #include "pdf/pdfium/pdfium_page.h"
+#include "pdf/pdfium/pdfium_page_bitmap_cache.h"
 #include "pdf/pdfium/pdfium_range.h"
 #include "ppapi/cpp/completion_callback.h"
 #include "ppapi/cpp/dev/buffer_dev.h"
@@ -331,6 +332,23 @@ class PDFiumEngine : public PDFEngine,
   // Stops any paints that are in progress.
   void CancelPaints();
 
+  // Returns true if a paint of |dirty|, in screen coordinates, should render
+  // the whole of page |page_index| into |page_bitmap_cache_| rather than just
+  // the dirty part into the plugin image.
+  bool ShouldCachePageBitmap(int page_index, const pp::Rect& dirty) const;
+
+  // Returns the cached rendering of page |page_index|, or NULL if there is
+  // none for the current zoom, rotation and rendering flags.
+  FPDF_BITMAP GetCachedPageBitmap(int page_index) const;
+
+  // Returns the rect of page |page_index| in document pixels at the current
+  // zoom level, which is where its whole-page rendering goes.
+  pp::Rect GetPageBitmapRect(int page_index) const;
+
+  // Returns the parameters a whole-page rendering of page |page_index| would
+  // currently be made with.
+  PDFiumPageBitmapCache::Params GetPageBitmapParams(int page_index) const;
+
   // Invalidates all pages. Use this when some global parameter, such as page
   // orientation, has changed.
   void InvalidateAllPages();
@@ -684,6 +702,8 @@ class PDFiumEngine : public PDFEngine,
   struct ProgressivePaint {
     pp::Rect rect;  // In screen coordinates.
     FPDF_BITMAP bitmap;
+    // Whole-page rendering in progress for |page_bitmap_cache_|, or NULL.
+    FPDF_BITMAP page_bitmap;
     int page_index;
     // Temporary used to figure out if in a series of Paint() calls whether this
     // pending paint was updated or not.
@@ -691,6 +711,8 @@ class PDFiumEngine : public PDFEngine,
   };
   std::vector<ProgressivePaint> progressive_paints_;
 
+  PDFiumPageBitmapCache page_bitmap_cache_;
+
   // Keeps track of when we started the last progressive paint, so that in our
   // callback we can determine if we need to pause.
   base::Time last_progressive_start_time_;
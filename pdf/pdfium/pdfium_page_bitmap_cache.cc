@@ -0,0 +1,111 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "pdf/pdfium/pdfium_page_bitmap_cache.h"
+
+#include <algorithm>
+
+#include "base/logging.h"
+
+namespace chrome_pdf {
+
+namespace {
+
+int64 GetPixels(const pp::Size& size) {
+  return static_cast<int64>(size.width()) * size.height();
+}
+
+}  // namespace
+
+// A letter-sized page at 100% zoom is about 0.8M pixels, so this is two such
+// pages at 150%, or one at 200%. At 4 bytes per pixel, the whole cache is at
+// most 16MB per document.
+const int64 PDFiumPageBitmapCache::kMaxPagePixels = 2 * 1024 * 1024;
+const int64 PDFiumPageBitmapCache::kMaxTotalPixels = 4 * 1024 * 1024;
+
+PDFiumPageBitmapCache::Params::Params()
+    : zoom(0),
+      rotation(0),
+      rendering_flags(0) {
+}
+
+PDFiumPageBitmapCache::Params::Params(const pp::Size& size,
+                                      double zoom,
+                                      int rotation,
+                                      int rendering_flags)
+    : size(size),
+      zoom(zoom),
+      rotation(rotation),
+      rendering_flags(rendering_flags) {
+}
+
+bool PDFiumPageBitmapCache::Params::operator==(const Params& other) const {
+  return size == other.size && zoom == other.zoom &&
+      rotation == other.rotation && rendering_flags == other.rendering_flags;
+}
+
+PDFiumPageBitmapCache::PDFiumPageBitmapCache() : total_pixels_(0) {
+}
+
+PDFiumPageBitmapCache::~PDFiumPageBitmapCache() {
+  Clear();
+}
+
+// static
+bool PDFiumPageBitmapCache::CanCache(const Params& params) {
+  int64 pixels = GetPixels(params.size);
+  return pixels > 0 && pixels <= kMaxPagePixels;
+}
+
+FPDF_BITMAP PDFiumPageBitmapCache::Get(int page_index,
+                                       const Params& params) const {
+  std::map<int, Entry>::const_iterator it = bitmaps_.find(page_index);
+  if (it == bitmaps_.end() || !(it->second.params == params))
+    return NULL;
+  return it->second.bitmap;
+}
+
+void PDFiumPageBitmapCache::Put(int page_index,
+                                const Params& params,
+                                FPDF_BITMAP bitmap,
+                                const std::vector<int>& visible_pages) {
+  DCHECK(CanCache(params));
+  DCHECK_EQ(params.size.width(), FPDFBitmap_GetWidth(bitmap));
+  DCHECK_EQ(params.size.height(), FPDFBitmap_GetHeight(bitmap));
+
+  std::map<int, Entry>::iterator it = bitmaps_.find(page_index);
+  if (it != bitmaps_.end())
+    Erase(it);
+
+  Entry& entry = bitmaps_[page_index];
+  entry.bitmap = bitmap;
+  entry.params = params;
+  total_pixels_ += GetPixels(params.size);
+
+  for (int pass = 0; pass < 2 && total_pixels_ > kMaxTotalPixels; ++pass) {
+    it = bitmaps_.begin();
+    while (it != bitmaps_.end() && total_pixels_ > kMaxTotalPixels) {
+      bool visible = std::find(visible_pages.begin(), visible_pages.end(),
+                               it->first) != visible_pages.end();
+      if (it->first == page_index || (pass == 0 && visible))
+        ++it;
+      else
+        Erase(it++);
+    }
+  }
+}
+
+void PDFiumPageBitmapCache::Clear() {
+  while (!bitmaps_.empty())
+    Erase(bitmaps_.begin());
+  DCHECK_EQ(0, total_pixels_);
+}
+
+void PDFiumPageBitmapCache::Erase(std::map<int, Entry>::iterator it) {
+  total_pixels_ -= GetPixels(it->second.params.size);
+  FPDFBitmap_Destroy(it->second.bitmap);
+  bitmaps_.erase(it);
+}
+
+}  // namespace chrome_pdf
@@ -0,0 +1,86 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PDF_PDFIUM_PDFIUM_PAGE_BITMAP_CACHE_H_
+#define PDF_PDFIUM_PDFIUM_PAGE_BITMAP_CACHE_H_
+
+#include <map>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "ppapi/cpp/size.h"
+#include "third_party/pdfium/fpdfsdk/include/fpdfview.h"
+
+namespace chrome_pdf {
+
+// Complete renderings of recently painted pages, keyed by page index, so that
+// repainting part of a page (e.g. the strip exposed by a scroll) is a copy
+// rather than another pass through PDFium.
+class PDFiumPageBitmapCache {
+ public:
+  // What a page was rendered with. A cached rendering is only reused while
+  // all of these are current. |size| is the page size in pixels at |zoom|,
+  // which doesn't depend on the scroll position.
+  struct Params {
+    Params();
+    Params(const pp::Size& size, double zoom, int rotation,
+           int rendering_flags);
+
+    bool operator==(const Params& other) const;
+
+    pp::Size size;
+    double zoom;
+    int rotation;
+    int rendering_flags;
+  };
+
+  // Pages larger than this many pixels are never cached.
+  static const int64 kMaxPagePixels;
+
+  // The most pixels kept across all cached pages.
+  static const int64 kMaxTotalPixels;
+
+  PDFiumPageBitmapCache();
+  ~PDFiumPageBitmapCache();
+
+  // Returns true if a page rendered with |params| may be cached.
+  static bool CanCache(const Params& params);
+
+  // Returns the rendering of page |page_index| made with |params|, or NULL if
+  // there is none.
+  FPDF_BITMAP Get(int page_index, const Params& params) const;
+
+  // Takes ownership of |bitmap|, a rendering of page |page_index| made with
+  // |params|, replacing any older one. Then, while the cache is over
+  // kMaxTotalPixels, evicts the pages not in |visible_pages|, then any page
+  // but |page_index|.
+  void Put(int page_index,
+           const Params& params,
+           FPDF_BITMAP bitmap,
+           const std::vector<int>& visible_pages);
+
+  // Drops every cached rendering.
+  void Clear();
+
+  size_t size() const { return bitmaps_.size(); }
+  int64 total_pixels() const { return total_pixels_; }
+
+ private:
+  struct Entry {
+    FPDF_BITMAP bitmap;
+    Params params;
+  };
+
+  // Destroys the bitmap at |it| and removes it from |bitmaps_|.
+  void Erase(std::map<int, Entry>::iterator it);
+
+  std::map<int, Entry> bitmaps_;
+  int64 total_pixels_;
+
+  DISALLOW_COPY_AND_ASSIGN(PDFiumPageBitmapCache);
+};
+
+}  // namespace chrome_pdf
+
+#endif  // PDF_PDFIUM_PDFIUM_PAGE_BITMAP_CACHE_H_
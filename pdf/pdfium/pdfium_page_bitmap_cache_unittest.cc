@@ -0,0 +1,110 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "pdf/pdfium/pdfium_page_bitmap_cache.h"
+
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace chrome_pdf {
+
+namespace {
+
+const int kRotation = 0;
+const int kRenderingFlags = 0;
+
+// A page that is a quarter of the cache's capacity.
+PDFiumPageBitmapCache::Params QuarterPageParams() {
+  return PDFiumPageBitmapCache::Params(pp::Size(1024, 1024), 1.0, kRotation,
+                                       kRenderingFlags);
+}
+
+}  // namespace
+
+class PDFiumPageBitmapCacheTest : public testing::Test {
+ protected:
+  void SetUp() override { FPDF_InitLibrary(); }
+  void TearDown() override { FPDF_DestroyLibrary(); }
+
+  static FPDF_BITMAP CreateBitmap(const PDFiumPageBitmapCache::Params& params) {
+    return FPDFBitmap_Create(params.size.width(), params.size.height(), 0);
+  }
+};
+
+TEST_F(PDFiumPageBitmapCacheTest, OnlyReusedWithSameParams) {
+  PDFiumPageBitmapCache cache;
+  const PDFiumPageBitmapCache::Params params(pp::Size(850, 1100), 1.0,
+                                             kRotation, kRenderingFlags);
+  FPDF_BITMAP bitmap = CreateBitmap(params);
+  cache.Put(0, params, bitmap, std::vector<int>());
+  EXPECT_EQ(bitmap, cache.Get(0, params));
+  EXPECT_FALSE(cache.Get(1, params));
+
+  PDFiumPageBitmapCache::Params other = params;
+  other.zoom = 1.5;
+  EXPECT_FALSE(cache.Get(0, other));
+  other = params;
+  other.rotation = 1;
+  EXPECT_FALSE(cache.Get(0, other));
+  other = params;
+  other.rendering_flags = 1;
+  EXPECT_FALSE(cache.Get(0, other));
+  other = params;
+  other.size = pp::Size(851, 1100);
+  EXPECT_FALSE(cache.Get(0, other));
+
+  // A new rendering of the page replaces the old one.
+  other = params;
+  other.zoom = 1.01;
+  FPDF_BITMAP other_bitmap = CreateBitmap(other);
+  cache.Put(0, other, other_bitmap, std::vector<int>());
+  EXPECT_EQ(1u, cache.size());
+  EXPECT_FALSE(cache.Get(0, params));
+  EXPECT_EQ(other_bitmap, cache.Get(0, other));
+
+  cache.Clear();
+  EXPECT_EQ(0u, cache.size());
+  EXPECT_EQ(0, cache.total_pixels());
+}
+
+TEST_F(PDFiumPageBitmapCacheTest, CanCache) {
+  EXPECT_TRUE(PDFiumPageBitmapCache::CanCache(QuarterPageParams()));
+  EXPECT_FALSE(PDFiumPageBitmapCache::CanCache(PDFiumPageBitmapCache::Params(
+      pp::Size(0, 1100), 1.0, kRotation, kRenderingFlags)));
+  EXPECT_FALSE(PDFiumPageBitmapCache::CanCache(PDFiumPageBitmapCache::Params(
+      pp::Size(1024, 1024 * 2 + 1), 1.0, kRotation, kRenderingFlags)));
+}
+
+TEST_F(PDFiumPageBitmapCacheTest, EvictsInvisiblePagesFirst) {
+  PDFiumPageBitmapCache cache;
+  const PDFiumPageBitmapCache::Params params = QuarterPageParams();
+  std::vector<int> visible_pages;
+  visible_pages.push_back(0);
+  visible_pages.push_back(3);
+  for (int i = 0; i < 4; ++i)
+    cache.Put(i, params, CreateBitmap(params), visible_pages);
+  EXPECT_EQ(4u, cache.size());
+  EXPECT_EQ(PDFiumPageBitmapCache::kMaxTotalPixels, cache.total_pixels());
+
+  // Page 1 is the first page that isn't visible.
+  cache.Put(4, params, CreateBitmap(params), visible_pages);
+  EXPECT_EQ(4u, cache.size());
+  EXPECT_FALSE(cache.Get(1, params));
+  EXPECT_TRUE(cache.Get(2, params));
+  EXPECT_TRUE(cache.Get(4, params));
+
+  // Once only visible pages are left, they are evicted too, but never the
+  // page just added.
+  visible_pages.push_back(2);
+  visible_pages.push_back(4);
+  visible_pages.push_back(5);
+  cache.Put(5, params, CreateBitmap(params), visible_pages);
+  EXPECT_EQ(4u, cache.size());
+  EXPECT_FALSE(cache.Get(0, params));
+  EXPECT_TRUE(cache.Get(5, params));
+  EXPECT_LE(cache.total_pixels(), PDFiumPageBitmapCache::kMaxTotalPixels);
+}
+
+}  // namespace chrome_pdf
@@ -4,6 +4,10 @@
 
 #include "ppapi/proxy/url_loader_resource.h"
 
+#include <string.h>
+
+#include <algorithm>
+
 #include "base/logging.h"
 #include "ppapi/c/pp_completion_callback.h"
 #include "ppapi/c/pp_errors.h"
@@ -22,11 +26,6 @@ using ppapi::thunk::EnterResourceNoLock;
 using ppapi::thunk::PPB_URLLoader_API;
 using ppapi::thunk::PPB_URLRequestInfo_API;
 
-#ifdef _MSC_VER
-// Do not warn about use of std::copy with raw pointers.
-#pragma warning(disable : 4996)
-#endif
-
 namespace ppapi {
 namespace proxy {
 
@@ -35,6 +34,8 @@ URLLoaderResource::URLLoaderResource(Connection connection,
     : PluginResource(connection, instance),
       mode_(MODE_WAITING_TO_OPEN),
       status_callback_(NULL),
+      buffer_offset_(0),
+      buffer_size_(0),
       bytes_sent_(0),
       total_bytes_to_be_sent_(-1),
       bytes_received_(0),
@@ -54,6 +55,8 @@ URLLoaderResource::URLLoaderResource(Connection connection,
     : PluginResource(connection, instance),
       mode_(MODE_OPENING),
       status_callback_(NULL),
+      buffer_offset_(0),
+      buffer_size_(0),
       bytes_sent_(0),
       total_bytes_to_be_sent_(-1),
       bytes_received_(0),
@@ -273,7 +276,19 @@ void URLLoaderResource::OnPluginMsgSendData(
   }
 
   mode_ = MODE_STREAMING_DATA;
-  buffer_.insert(buffer_.end(), data, data + data_length);
+
+  // If the plugin is already waiting in ReadResponseBody() and nothing is
+  // queued ahead of this data, copy it straight out of the message rather
+  // than staging it in |buffer_| first.
+  size_t bytes_read = 0;
+  if (user_buffer_ && buffer_.empty()) {
+    bytes_read = std::min(static_cast<size_t>(data_length), user_buffer_size_);
+    memcpy(user_buffer_, data, bytes_read);
+  }
+  if (bytes_read < static_cast<size_t>(data_length)) {
+    buffer_.push_back(std::string(data + bytes_read, data_length - bytes_read));
+    buffer_size_ += data_length - bytes_read;
+  }
 
   // To avoid letting the network stack download an entire stream all at once,
   // defer loading when we have enough buffer.
@@ -283,16 +298,21 @@ void URLLoaderResource::OnPluginMsgSendData(
          request_data_.prefetch_buffer_upper_threshold);
   if (!is_streaming_to_file_ &&
       !is_asynchronous_load_suspended_ &&
-      (buffer_.size() >= static_cast<size_t>(
+      (buffer_size_ >= static_cast<size_t>(
           request_data_.prefetch_buffer_upper_threshold))) {
-    DVLOG(1) << "Suspending async load - buffer size: " << buffer_.size();
+    DVLOG(1) << "Suspending async load - buffer size: " << buffer_size_;
     SetDefersLoading(true);
   }
 
-  if (user_buffer_)
+  if (bytes_read) {
+    user_buffer_ = NULL;
+    user_buffer_size_ = 0;
+    RunCallback(static_cast<int32_t>(bytes_read));
+  } else if (user_buffer_) {
     RunCallback(FillUserBuffer());
-  else
+  } else {
     DCHECK(!TrackedCallback::IsPending(pending_callback_));
+  }
 }
 
 void URLLoaderResource::OnPluginMsgFinishedLoading(
@@ -328,6 +348,7 @@ void URLLoaderResource::OnPluginMsgUpdateProgress(
 }
 
 void URLLoaderResource::SetDefersLoading(bool defers_loading) {
+  is_asynchronous_load_suspended_ = defers_loading;
   Post(RENDERER, PpapiHostMsg_URLLoader_SetDeferLoading(defers_loading));
 }
 
@@ -378,15 +399,27 @@ size_t URLLoaderResource::FillUserBuffer() {
   DCHECK(user_buffer_);
   DCHECK(user_buffer_size_);
 
-  size_t bytes_to_copy = std::min(buffer_.size(), user_buffer_size_);
-  std::copy(buffer_.begin(), buffer_.begin() + bytes_to_copy, user_buffer_);
-  buffer_.erase(buffer_.begin(), buffer_.begin() + bytes_to_copy);
+  size_t bytes_to_copy = std::min(buffer_size_, user_buffer_size_);
+  size_t bytes_copied = 0;
+  while (bytes_copied < bytes_to_copy) {
+    const std::string& chunk = buffer_.front();
+    size_t bytes = std::min(chunk.size() - buffer_offset_,
+                            bytes_to_copy - bytes_copied);
+    memcpy(user_buffer_ + bytes_copied, chunk.data() + buffer_offset_, bytes);
+    bytes_copied += bytes;
+    buffer_offset_ += bytes;
+    if (buffer_offset_ == chunk.size()) {
+      buffer_.pop_front();
+      buffer_offset_ = 0;
+    }
+  }
+  buffer_size_ -= bytes_to_copy;
 
   // If the buffer is getting too empty, resume asynchronous loading.
   if (is_asynchronous_load_suspended_ &&
-      buffer_.size() <= static_cast<size_t>(
+      buffer_size_ <= static_cast<size_t>(
           request_data_.prefetch_buffer_lower_threshold)) {
-    DVLOG(1) << "Resuming async load - buffer size: " << buffer_.size();
+    DVLOG(1) << "Resuming async load - buffer size: " << buffer_size_;
     SetDefersLoading(false);
   }
 
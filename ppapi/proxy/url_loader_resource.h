@@ -6,6 +6,7 @@
 #define PPAPI_PROXY_URL_LOADER_RESOURCE_H_
 
 #include <deque>
+#include <string>
 
 #include "base/basictypes.h"
 #include "base/compiler_specific.h"
@@ -123,7 +124,13 @@ class PPAPI_PROXY_EXPORT URLLoaderResource
 
   PP_URLLoaderTrusted_StatusCallback status_callback_;
 
-  std::deque<char> buffer_;
+  // Response body data received from the host but not yet read by the
+  // plugin, kept as the chunks it arrived in. The first |buffer_offset_|
+  // bytes of the front chunk have already been read, and |buffer_size_| is
+  // the number of unread bytes across all chunks.
+  std::deque<std::string> buffer_;
+  size_t buffer_offset_;
+  size_t buffer_size_;
   int64_t bytes_sent_;
   int64_t total_bytes_to_be_sent_;
   int64_t bytes_received_;
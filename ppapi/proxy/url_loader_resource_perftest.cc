@@ -0,0 +1,105 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+#include <vector>
+
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
+#include "ppapi/c/pp_errors.h"
+#include "ppapi/c/ppb_url_loader.h"
+#include "ppapi/proxy/locking_resource_releaser.h"
+#include "ppapi/proxy/plugin_message_filter.h"
+#include "ppapi/proxy/ppapi_messages.h"
+#include "ppapi/proxy/ppapi_proxy_test.h"
+#include "ppapi/shared_impl/url_response_info_data.h"
+#include "ppapi/thunk/thunk.h"
+#include "testing/perf/perf_test.h"
+
+namespace ppapi {
+namespace proxy {
+
+namespace {
+
+// Total size of the simulated response body for each configuration.
+const int kResponseSize = 64 * 1024 * 1024;
+
+int32_t g_callback_result;
+
+void Callback(void* user_data, int32_t result) {
+  g_callback_result = result;
+}
+
+class URLLoaderResourcePerfTest : public PluginProxyTest {
+ protected:
+  // Streams kResponseSize bytes through a URLLoader in |chunk_size| messages
+  // from the host, with the plugin reading |read_size| bytes at a time, and
+  // reports the resulting throughput. When |read_ahead| is set, every chunk
+  // is buffered before the plugin reads it; otherwise each chunk arrives
+  // while a read is pending.
+  void RunDownload(int chunk_size, int read_size, bool read_ahead) {
+    const PPB_URLLoader_1_0* loader_iface =
+        thunk::GetPPB_URLLoader_1_0_Thunk();
+    LockingResourceReleaser loader(loader_iface->Create(pp_instance()));
+
+    ResourceMessageReplyParams reply_params(loader.get(), 0);
+    reply_params.set_result(PP_OK);
+    PluginMessageFilter::DispatchResourceReplyForTest(
+        reply_params,
+        PpapiPluginMsg_URLLoader_ReceivedResponse(URLResponseInfoData()));
+
+    const std::string chunk(chunk_size, 'x');
+    std::vector<char> read_buffer(read_size);
+    int64 bytes_read = 0;
+
+    base::TimeTicks start = base::TimeTicks::Now();
+    for (int sent = 0; sent < kResponseSize; sent += chunk_size) {
+      g_callback_result = PP_OK_COMPLETIONPENDING;
+      if (!read_ahead) {
+        ASSERT_EQ(PP_OK_COMPLETIONPENDING,
+                  loader_iface->ReadResponseBody(
+                      loader.get(), &read_buffer[0], read_size,
+                      PP_MakeCompletionCallback(&Callback, NULL)));
+      }
+      PpapiPluginMsg_URLLoader_SendData message;
+      message.WriteData(chunk.data(), chunk.size());
+      PluginMessageFilter::DispatchResourceReplyForTest(reply_params, message);
+      if (!read_ahead) {
+        ASSERT_GT(g_callback_result, 0);
+        bytes_read += g_callback_result;
+      }
+    }
+    while (bytes_read < kResponseSize) {
+      int32_t result = loader_iface->ReadResponseBody(
+          loader.get(), &read_buffer[0], read_size,
+          PP_MakeCompletionCallback(&Callback, NULL));
+      ASSERT_GT(result, 0);
+      bytes_read += result;
+    }
+    base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+
+    perf_test::PrintResult(
+        "url_loader_throughput",
+        base::StringPrintf("_%dk_chunks_%dk_reads", chunk_size / 1024,
+                           read_size / 1024),
+        read_ahead ? "buffered" : "pending_read",
+        kResponseSize / (1024.0 * 1024.0) / elapsed.InSecondsF(),
+        "MB/s", true);
+  }
+};
+
+}  // namespace
+
+TEST_F(URLLoaderResourcePerfTest, PendingReads) {
+  RunDownload(32 * 1024, 32 * 1024, false);
+  RunDownload(32 * 1024, 256 * 1024, false);
+}
+
+TEST_F(URLLoaderResourcePerfTest, BufferedReads) {
+  RunDownload(32 * 1024, 4 * 1024, true);
+  RunDownload(32 * 1024, 256 * 1024, true);
+}
+
+}  // namespace proxy
+}  // namespace ppapi
@@ -4,6 +4,9 @@
 
 #include "printing/pdf_metafile_skia.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "base/containers/hash_tables.h"
 #include "base/files/file_util.h"
 #include "base/metrics/histogram.h"
@@ -11,7 +14,6 @@
 #include "base/posix/eintr_wrapper.h"
 #include "skia/ext/refptr.h"
 #include "skia/ext/vector_canvas.h"
-#include "third_party/skia/include/core/SkData.h"
 #include "third_party/skia/include/core/SkRefCnt.h"
 #include "third_party/skia/include/core/SkScalar.h"
 #include "third_party/skia/include/core/SkStream.h"
@@ -32,11 +34,22 @@
 
 namespace printing {
 
+namespace {
+
+// Size of the pieces the serialized PDF is written to a file in.
+const size_t kSaveChunkSize = 64 * 1024;
+
+}  // namespace
+
 struct PdfMetafileSkiaData {
   skia::RefPtr<SkPDFDevice> current_page_;
   skia::RefPtr<SkCanvas> current_page_canvas_;
-  SkPDFDocument pdf_doc_;
-  SkDynamicMemoryWStream pdf_stream_;
+  // Holds the recorded pages until FinishDocument() serializes them into
+  // |pdf_data_|, after which it is released.
+  scoped_ptr<SkPDFDocument> pdf_doc_;
+  // The serialized document. Read sequentially, from its start, each time
+  // it is needed.
+  skia::RefPtr<SkStreamAsset> pdf_data_;
 #if defined(OS_MACOSX)
   PdfMetafileCg pdf_cg_;
 #endif
@@ -49,7 +62,9 @@ bool PdfMetafileSkia::Init() {
 }
 bool PdfMetafileSkia::InitFromData(const void* src_buffer,
                                    uint32 src_buffer_size) {
-  return data_->pdf_stream_.write(src_buffer, src_buffer_size);
+  data_->pdf_data_ = skia::AdoptRef(
+      new SkMemoryStream(src_buffer, src_buffer_size, true /* copyData */));
+  return true;
 }
 
 bool PdfMetafileSkia::StartPage(const gfx::Size& page_size,
@@ -87,24 +102,29 @@ skia::VectorCanvas* PdfMetafileSkia::GetVectorCanvasForNewPage(
 bool PdfMetafileSkia::FinishPage() {
   DCHECK(data_->current_page_canvas_);
   DCHECK(data_->current_page_);
+  DCHECK(data_->pdf_doc_);
 
   data_->current_page_canvas_.clear();  // Unref SkCanvas.
-  data_->pdf_doc_.appendPage(data_->current_page_.get());
+  data_->pdf_doc_->appendPage(data_->current_page_.get());
   return true;
 }
 
 bool PdfMetafileSkia::FinishDocument() {
   // Don't do anything if we've already set the data in InitFromData.
-  if (data_->pdf_stream_.getOffset())
+  if (data_->pdf_data_)
     return true;
 
+  // The document is released once serialized, so it can only be finished once.
+  if (!data_->pdf_doc_)
+    return false;
+
   if (data_->current_page_canvas_)
     FinishPage();
 
   data_->current_page_.clear();
 
   int font_counts[SkAdvancedTypefaceMetrics::kOther_Font + 2];
-  data_->pdf_doc_.getCountOfFontTypes(font_counts);
+  data_->pdf_doc_->getCountOfFontTypes(font_counts);
   for (int type = 0;
        type <= SkAdvancedTypefaceMetrics::kOther_Font + 1;
        type++) {
@@ -115,21 +135,33 @@ bool PdfMetafileSkia::FinishDocument() {
     }
   }
 
-  return data_->pdf_doc_.emitPDF(&data_->pdf_stream_);
+  SkDynamicMemoryWStream pdf_stream;
+  bool result = data_->pdf_doc_->emitPDF(&pdf_stream);
+  data_->pdf_data_ = skia::AdoptRef(pdf_stream.detachAsStream());
+
+  // The pages are not needed once serialized. Free them now rather than
+  // holding a second copy of a possibly large document for as long as the
+  // metafile is alive.
+  data_->pdf_doc_.reset();
+  return result;
 }
 
 uint32 PdfMetafileSkia::GetDataSize() const {
-  return base::checked_cast<uint32>(data_->pdf_stream_.getOffset());
+  if (!data_->pdf_data_)
+    return 0;
+  return base::checked_cast<uint32>(data_->pdf_data_->getLength());
 }
 
 bool PdfMetafileSkia::GetData(void* dst_buffer,
                               uint32 dst_buffer_size) const {
-  if (dst_buffer_size < GetDataSize())
+  uint32 size = GetDataSize();
+  if (dst_buffer_size < size)
     return false;
+  if (size == 0)
+    return true;
 
-  SkAutoDataUnref data(data_->pdf_stream_.copyToData());
-  memcpy(dst_buffer, data->bytes(), dst_buffer_size);
-  return true;
+  return data_->pdf_data_->rewind() &&
+      data_->pdf_data_->read(dst_buffer, size) == size;
 }
 
 gfx::Rect PdfMetafileSkia::GetPageBounds(unsigned int page_number) const {
@@ -174,29 +206,44 @@ bool PdfMetafileSkia::RenderPage(unsigned int page_number,
                                  CGContextRef context,
                                  const CGRect rect,
                                  const MacRenderPageParams& params) const {
-  DCHECK_GT(data_->pdf_stream_.getOffset(), 0U);
+  DCHECK_GT(GetDataSize(), 0U);
   if (data_->pdf_cg_.GetDataSize() == 0) {
-    SkAutoDataUnref data(data_->pdf_stream_.copyToData());
-    data_->pdf_cg_.InitFromData(data->bytes(), data->size());
+    std::vector<char> data(GetDataSize());
+    if (!GetData(&data[0], data.size()))
+      return false;
+    data_->pdf_cg_.InitFromData(&data[0], data.size());
   }
   return data_->pdf_cg_.RenderPage(page_number, context, rect, params);
 }
 #endif
 
 bool PdfMetafileSkia::SaveTo(base::File* file) const {
-  if (GetDataSize() == 0U)
+  size_t size = GetDataSize();
+  if (size == 0U)
     return false;
-  SkAutoDataUnref data(data_->pdf_stream_.copyToData());
-  // TODO(halcanary): rewrite this function without extra data copy
-  // using SkStreamAsset.
-  const char* ptr = reinterpret_cast<const char*>(data->data());
-  int size = base::checked_cast<int>(data->size());
-  return file->WriteAtCurrentPos(ptr, size) == size;
+
+  // Write the stream out a piece at a time instead of flattening it into one
+  // more copy of the whole document first. Reading it sequentially keeps
+  // this linear in the size of the document.
+  if (!data_->pdf_data_->rewind())
+    return false;
+  scoped_ptr<char[]> buffer(new char[std::min(size, kSaveChunkSize)]);
+  for (size_t offset = 0; offset < size; offset += kSaveChunkSize) {
+    size_t chunk_size = std::min(size - offset, kSaveChunkSize);
+    if (data_->pdf_data_->read(buffer.get(), chunk_size) != chunk_size)
+      return false;
+    int chunk_size_int = base::checked_cast<int>(chunk_size);
+    if (file->WriteAtCurrentPos(buffer.get(), chunk_size_int) !=
+        chunk_size_int) {
+      return false;
+    }
+  }
+  return true;
 }
 
 #if defined(OS_CHROMEOS) || defined(OS_ANDROID)
 bool PdfMetafileSkia::SaveToFD(const base::FileDescriptor& fd) const {
-  DCHECK_GT(data_->pdf_stream_.getOffset(), 0U);
+  DCHECK_GT(GetDataSize(), 0U);
 
   if (fd.fd < 0) {
     DLOG(ERROR) << "Invalid file descriptor!";
@@ -213,6 +260,7 @@ bool PdfMetafileSkia::SaveToFD(const base::FileDescriptor& fd) const {
 #endif
 
 PdfMetafileSkia::PdfMetafileSkia() : data_(new PdfMetafileSkiaData) {
+  data_->pdf_doc_.reset(new SkPDFDocument);
 }
 
 scoped_ptr<PdfMetafileSkia> PdfMetafileSkia::GetMetafileForCurrentPage() {
@@ -221,19 +269,15 @@ scoped_ptr<PdfMetafileSkia> PdfMetafileSkia::GetMetafileForCurrentPage() {
   if (!pdf_doc.appendPage(data_->current_page_.get()))
     return metafile.Pass();
 
+  // Hand the serialized page straight to the new metafile, rather than have
+  // InitFromData() copy it.
   SkDynamicMemoryWStream pdf_stream;
   if (!pdf_doc.emitPDF(&pdf_stream))
     return metafile.Pass();
-
-  SkAutoDataUnref data_copy(pdf_stream.copyToData());
-  if (data_copy->size() == 0)
-    return scoped_ptr<PdfMetafileSkia>();
-
   metafile.reset(new PdfMetafileSkia);
-  if (!metafile->InitFromData(data_copy->bytes(),
-                              base::checked_cast<uint32>(data_copy->size()))) {
+  metafile->data_->pdf_data_ = skia::AdoptRef(pdf_stream.detachAsStream());
+  if (metafile->GetDataSize() == 0)
     metafile.reset();
-  }
   return metafile.Pass();
 }
 
@@ -6,6 +6,10 @@
 
 #include <math.h>
 
+#include <algorithm>
+#include <vector>
+
+#include "base/basictypes.h"
 #include "base/logging.h"
 #include "base/strings/stringprintf.h"
 #include "base/time/time.h"
@@ -20,6 +24,40 @@ namespace remoting {
 
 enum { kBytesPerPixelRGB32 = 4 };
 
+// Number of following rectangles that CoalesceRegion() considers merging
+// with each rectangle. DesktopRegion yields rectangles in row order, so
+// nearby rectangles are usually close together in the list.
+const size_t kCoalesceWindow = 16;
+
+// Regions with more rectangles than this are left alone by CoalesceRegion(),
+// to bound its cost per frame.
+const size_t kMaxCoalesceRects = 1024;
+
+// Most passes CoalesceRegion() makes over the rectangles.
+const int kMaxCoalescePasses = 4;
+
+int GetArea(const webrtc::DesktopRect& rect) {
+  return rect.width() * rect.height();
+}
+
+// Returns the number of rectangles DesktopRegion splits |a| and |b| into. It
+// keeps rectangles in rows of equal top and bottom, so two rectangles which
+// partly overlap vertically take up to three rows.
+int CountRowRects(const webrtc::DesktopRect& a, const webrtc::DesktopRect& b) {
+  int edges[] = { a.top(), a.bottom(), b.top(), b.bottom() };
+  std::sort(edges, edges + arraysize(edges));
+  int count = 0;
+  for (size_t i = 0; i + 1 < arraysize(edges); ++i) {
+    if (edges[i] == edges[i + 1])
+      continue;
+    if (a.top() <= edges[i] && edges[i] < a.bottom())
+      ++count;
+    if (b.top() <= edges[i] && edges[i] < b.bottom())
+      ++count;
+  }
+  return count;
+}
+
 // Do not write LOG messages in this routine since it is called from within
 // our LOG message handler. Bad things will happen.
 std::string GetTimestampString() {
@@ -186,6 +224,65 @@ webrtc::DesktopRect ScaleRect(const webrtc::DesktopRect& rect,
   return webrtc::DesktopRect::MakeLTRB(left, top, right, bottom);
 }
 
+void CoalesceRegion(int rect_cost, webrtc::DesktopRegion* region) {
+  std::vector<webrtc::DesktopRect> rects;
+  for (webrtc::DesktopRegion::Iterator i(*region); !i.IsAtEnd(); i.Advance())
+    rects.push_back(i.rect());
+  if (rects.size() > kMaxCoalesceRects)
+    return;
+
+  // Merges are judged from the two rectangles alone, without copying the
+  // region. A merged rectangle replaces the first of the two, and the second
+  // is emptied.
+  bool coalesced = false;
+  bool merged = true;
+  for (int pass = 0; merged && pass < kMaxCoalescePasses; ++pass) {
+    merged = false;
+    for (size_t i = 0; i < rects.size(); ++i) {
+      for (size_t j = i + 1;
+           j < rects.size() && j <= i + kCoalesceWindow; ++j) {
+        const webrtc::DesktopRect& a = rects[i];
+        const webrtc::DesktopRect& b = rects[j];
+        if (a.is_empty() || b.is_empty())
+          continue;
+
+        int rects_saved = CountRowRects(a, b) - 1;
+        if (rects_saved <= 0)
+          continue;
+        webrtc::DesktopRect bounds = webrtc::DesktopRect::MakeLTRB(
+            std::min(a.left(), b.left()), std::min(a.top(), b.top()),
+            std::max(a.right(), b.right()), std::max(a.bottom(), b.bottom()));
+        webrtc::DesktopRect overlap = a;
+        overlap.IntersectWith(b);
+        int added =
+            GetArea(bounds) - GetArea(a) - GetArea(b) + GetArea(overlap);
+        if (added > rects_saved * rect_cost)
+          continue;
+
+        rects[i] = bounds;
+        rects[j] = webrtc::DesktopRect();
+        merged = true;
+        coalesced = true;
+      }
+    }
+  }
+  if (!coalesced)
+    return;
+
+  // A merged rectangle may still split rows it shares with other rectangles,
+  // so keep the original region if the result has more rectangles after all.
+  webrtc::DesktopRegion result;
+  for (size_t i = 0; i < rects.size(); ++i) {
+    if (!rects[i].is_empty())
+      result.AddRect(rects[i]);
+  }
+  size_t result_rects = 0;
+  for (webrtc::DesktopRegion::Iterator i(result); !i.IsAtEnd(); i.Advance())
+    ++result_rects;
+  if (result_rects <= rects.size())
+    region->Swap(&result);
+}
+
 void CopyRGB32Rect(const uint8* source_buffer,
                    int source_stride,
                    const webrtc::DesktopRect& source_buffer_rect,
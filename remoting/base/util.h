@@ -10,6 +10,10 @@
 #include "media/base/video_frame.h"
 #include "third_party/webrtc/modules/desktop_capture/desktop_geometry.h"
 
+namespace webrtc {
+class DesktopRegion;
+}  // namespace webrtc
+
 namespace remoting {
 
 // Return a string that contains the current date formatted as 'MMDD/HHMMSS:'.
@@ -62,6 +66,15 @@ webrtc::DesktopRect ScaleRect(const webrtc::DesktopRect& rect,
                               const webrtc::DesktopSize& in_size,
                               const webrtc::DesktopSize& out_size);
 
+// Merges nearby rectangles of |region| into their bounding box whenever the
+// pixels this adds to the region cost no more than the rectangles it saves,
+// with |rect_cost| the estimated cost of processing one more rectangle
+// expressed in pixels. Many scattered small changes then turn into a few
+// larger rectangles. The number of rectangles in |region| never increases.
+// Regions with very many rectangles are left as they are, so that the cost
+// stays small next to encoding them.
+void CoalesceRegion(int rect_cost, webrtc::DesktopRegion* region);
+
 // Copy content of a rectangle in a RGB32 image.
 void CopyRGB32Rect(const uint8* source_buffer,
                    int source_stride,
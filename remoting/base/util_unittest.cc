@@ -8,6 +8,7 @@
 #include "testing/gtest/include/gtest/gtest.h"
 #include "third_party/libyuv/include/libyuv/convert_from_argb.h"
 #include "third_party/webrtc/modules/desktop_capture/desktop_geometry.h"
+#include "third_party/webrtc/modules/desktop_capture/desktop_region.h"
 
 static const int kWidth = 32 ;
 static const int kHeight = 24 ;
@@ -285,4 +286,59 @@ TEST(StringIsUtf8Test, Basic) {
   EXPECT_FALSE(StringIsUtf8("\xc0\xc0", 2));
 }
 
+static int CountRects(const webrtc::DesktopRegion& region) {
+  int count = 0;
+  for (webrtc::DesktopRegion::Iterator i(region); !i.IsAtEnd(); i.Advance())
+    ++count;
+  return count;
+}
+
+TEST(CoalesceRegionTest, MergesNearbyRects) {
+  webrtc::DesktopRegion region;
+  region.AddRect(webrtc::DesktopRect::MakeXYWH(0, 0, 10, 10));
+  region.AddRect(webrtc::DesktopRect::MakeXYWH(12, 0, 10, 10));
+  region.AddRect(webrtc::DesktopRect::MakeXYWH(0, 12, 10, 10));
+
+  // Merging the first two rectangles adds 20 pixels, and merging the result
+  // with the third adds another 164.
+  CoalesceRegion(200, &region);
+
+  webrtc::DesktopRegion::Iterator i(region);
+  ASSERT_FALSE(i.IsAtEnd());
+  EXPECT_TRUE(i.rect().equals(webrtc::DesktopRect::MakeXYWH(0, 0, 22, 22)));
+  i.Advance();
+  EXPECT_TRUE(i.IsAtEnd());
+}
+
+TEST(CoalesceRegionTest, KeepsDistantRects) {
+  webrtc::DesktopRegion region;
+  region.AddRect(webrtc::DesktopRect::MakeXYWH(0, 0, 10, 10));
+  region.AddRect(webrtc::DesktopRect::MakeXYWH(100, 100, 10, 10));
+  webrtc::DesktopRegion expected(region);
+
+  CoalesceRegion(200, &region);
+  EXPECT_TRUE(region.Equals(expected));
+}
+
+// Coalescing must never leave more rectangles than it started with, nor drop
+// any updated pixels, however the rectangles overlap once merged.
+TEST(CoalesceRegionTest, NeverAddsRects) {
+  for (int seed = 0; seed < 50; ++seed) {
+    webrtc::DesktopRegion region;
+    for (int i = 0; i < 20; ++i) {
+      region.AddRect(webrtc::DesktopRect::MakeXYWH(
+          (seed * 37 + i * 53) % 200, (seed * 91 + i * 29) % 200,
+          4 + (i * 7) % 20, 4 + (i * 11) % 20));
+    }
+    webrtc::DesktopRegion original(region);
+
+    CoalesceRegion(200, &region);
+    EXPECT_LE(CountRects(region), CountRects(original)) << seed;
+
+    webrtc::DesktopRegion dropped(original);
+    dropped.Subtract(region);
+    EXPECT_TRUE(dropped.is_empty()) << seed;
+  }
+}
+
 }  // namespace remoting
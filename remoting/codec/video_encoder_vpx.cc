@@ -4,10 +4,16 @@
 
 #include "remoting/codec/video_encoder_vpx.h"
 
+#include <algorithm>
+
+#include "base/barrier_closure.h"
 #include "base/bind.h"
+#include "base/bits.h"
 #include "base/command_line.h"
 #include "base/logging.h"
+#include "base/synchronization/waitable_event.h"
 #include "base/sys_info.h"
+#include "base/threading/worker_pool.h"
 #include "remoting/base/util.h"
 #include "remoting/proto/video.pb.h"
 #include "third_party/libyuv/include/libyuv/convert_from_argb.h"
@@ -39,6 +45,34 @@ const int kMacroBlockSize = 16;
 const int kVp9I420ProfileNumber = 0;
 const int kVp9I444ProfileNumber = 1;
 
+// Upper bound on the number of threads used to encode and convert a frame.
+const int kMaxThreads = 8;
+
+// Number of frame pixels that justify one more encoder thread.
+const int kPixelsPerEncoderThread = 640 * 480;
+
+// Minimum number of updated pixels that justify one more thread for the
+// RGB to YUV conversion.
+const int kPixelsPerConversionThread = 256 * 256;
+
+// VP8 supports at most 2^3 token partitions.
+const int kMaxVp8TokenPartitionsLog2 = 3;
+
+// Returns the number of threads to use for frames of |size|. Using multiple
+// threads gives a great boost in performance for most systems with adequate
+// processing power, so scale with both the number of cores and the frame
+// size. NB: Going to multiple threads on low end windows systems can really
+// hurt performance.
+// http://crbug.com/99179
+int GetThreadCount(const webrtc::DesktopSize& size) {
+  int num_cores = base::SysInfo::NumberOfProcessors();
+  if (num_cores <= 2)
+    return 1;
+  int num_threads =
+      std::max(2, size.width() * size.height() / kPixelsPerEncoderThread);
+  return std::min(num_threads, std::min(num_cores, kMaxThreads));
+}
+
 void SetCommonCodecParameters(const webrtc::DesktopSize& size,
                               vpx_codec_enc_cfg_t* config) {
   // Use millisecond granularity time base.
@@ -62,11 +96,7 @@ void SetCommonCodecParameters(const webrtc::DesktopSize& size,
   config->kf_min_dist = 10000;
   config->kf_max_dist = 10000;
 
-  // Using 2 threads gives a great boost in performance for most systems with
-  // adequate processing power. NB: Going to multiple threads on low end
-  // windows systems can really hurt performance.
-  // http://crbug.com/99179
-  config->g_threads = (base::SysInfo::NumberOfProcessors() > 2) ? 2 : 1;
+  config->g_threads = GetThreadCount(size);
 }
 
 ScopedVpxCodec CreateVP8Codec(const webrtc::DesktopSize& size) {
@@ -104,6 +134,15 @@ ScopedVpxCodec CreateVP8Codec(const webrtc::DesktopSize& size) {
   if (vpx_codec_control(codec.get(), VP8E_SET_NOISE_SENSITIVITY, 0))
     return ScopedVpxCodec();
 
+  // Split the tokens into one partition per thread, so that the threads
+  // can write the bitstream in parallel as well.
+  int token_partitions = std::min(base::bits::Log2Floor(config.g_threads),
+                                  kMaxVp8TokenPartitionsLog2);
+  if (vpx_codec_control(codec.get(), VP8E_SET_TOKEN_PARTITIONS,
+                        token_partitions)) {
+    return ScopedVpxCodec();
+  }
+
   return codec.Pass();
 }
 
@@ -157,6 +196,13 @@ ScopedVpxCodec CreateVP9Codec(const webrtc::DesktopSize& size,
     return ScopedVpxCodec();
   }
 
+  // Give each thread its own column of tiles to encode. libvpx clamps this
+  // to the number of columns the frame width allows.
+  if (vpx_codec_control(codec.get(), VP9E_SET_TILE_COLUMNS,
+                        base::bits::Log2Floor(config.g_threads))) {
+    return ScopedVpxCodec();
+  }
+
   return codec.Pass();
 }
 
@@ -223,8 +269,67 @@ void CreateImage(bool use_i444,
   *out_image_buffer = image_buffer.Pass();
 }
 
+// Converts |rects| of the RGB |frame| into the YUV planes of |image|. The
+// rectangles must lie within |image| and have even-aligned top-left corners.
+void ConvertRectsToYuv(const webrtc::DesktopFrame* frame,
+                       const vpx_image_t* image,
+                       const std::vector<webrtc::DesktopRect>* rects) {
+  const uint8* rgb_data = frame->data();
+  const int rgb_stride = frame->stride();
+  const int y_stride = image->stride[0];
+  DCHECK_EQ(image->stride[1], image->stride[2]);
+  const int uv_stride = image->stride[1];
+  uint8* y_data = image->planes[0];
+  uint8* u_data = image->planes[1];
+  uint8* v_data = image->planes[2];
+
+  switch (image->fmt) {
+    case VPX_IMG_FMT_I444:
+      for (size_t i = 0; i < rects->size(); ++i) {
+        const webrtc::DesktopRect& rect = (*rects)[i];
+        int rgb_offset = rgb_stride * rect.top() +
+                         rect.left() * kBytesPerRgbPixel;
+        int yuv_offset = uv_stride * rect.top() + rect.left();
+        libyuv::ARGBToI444(rgb_data + rgb_offset, rgb_stride,
+                           y_data + yuv_offset, y_stride,
+                           u_data + yuv_offset, uv_stride,
+                           v_data + yuv_offset, uv_stride,
+                           rect.width(), rect.height());
+      }
+      break;
+    case VPX_IMG_FMT_YV12:
+      for (size_t i = 0; i < rects->size(); ++i) {
+        const webrtc::DesktopRect& rect = (*rects)[i];
+        int rgb_offset = rgb_stride * rect.top() +
+                         rect.left() * kBytesPerRgbPixel;
+        int y_offset = y_stride * rect.top() + rect.left();
+        int uv_offset = uv_stride * rect.top() / 2 + rect.left() / 2;
+        libyuv::ARGBToI420(rgb_data + rgb_offset, rgb_stride,
+                           y_data + y_offset, y_stride,
+                           u_data + uv_offset, uv_stride,
+                           v_data + uv_offset, uv_stride,
+                           rect.width(), rect.height());
+      }
+      break;
+    default:
+      NOTREACHED();
+      break;
+  }
+}
+
+void ConvertRectsToYuvAndSignal(const webrtc::DesktopFrame* frame,
+                                const vpx_image_t* image,
+                                const std::vector<webrtc::DesktopRect>* rects,
+                                const base::Closure& done_callback) {
+  ConvertRectsToYuv(frame, image, rects);
+  done_callback.Run();
+}
+
 } // namespace
 
+const int VideoEncoderVpx::kCoalesceRectCost =
+    2 * kMacroBlockSize * kMacroBlockSize;
+
 // static
 scoped_ptr<VideoEncoderVpx> VideoEncoderVpx::CreateForVP8() {
   return make_scoped_ptr(new VideoEncoderVpx(false));
@@ -386,6 +491,11 @@ void VideoEncoderVpx::PrepareImage(const webrtc::DesktopFrame& frame,
   updated_region->Clear();
   updated_region->AddRects(&aligned_rects[0], aligned_rects.size());
 
+  // Screens with scattered small changes yield many tiny rectangles, each of
+  // which costs a conversion call and a dirty rect in the packet. Merge the
+  // nearby ones. Merging keeps the top-left corners even-aligned.
+  CoalesceRegion(kCoalesceRectCost, updated_region);
+
   // Clip back to the screen dimensions, in case they're not macroblock aligned.
   // The conversion routines don't require even width & height, so this is safe
   // even if the source dimensions are not even.
@@ -393,49 +503,63 @@ void VideoEncoderVpx::PrepareImage(const webrtc::DesktopFrame& frame,
       webrtc::DesktopRect::MakeWH(image_->w, image_->h));
 
   // Convert the updated region to YUV ready for encoding.
-  const uint8* rgb_data = frame.data();
-  const int rgb_stride = frame.stride();
-  const int y_stride = image_->stride[0];
-  DCHECK_EQ(image_->stride[1], image_->stride[2]);
-  const int uv_stride = image_->stride[1];
-  uint8* y_data = image_->planes[0];
-  uint8* u_data = image_->planes[1];
-  uint8* v_data = image_->planes[2];
-
-  switch (image_->fmt) {
-    case VPX_IMG_FMT_I444:
-      for (webrtc::DesktopRegion::Iterator r(*updated_region); !r.IsAtEnd();
-           r.Advance()) {
-        const webrtc::DesktopRect& rect = r.rect();
-        int rgb_offset = rgb_stride * rect.top() +
-                         rect.left() * kBytesPerRgbPixel;
-        int yuv_offset = uv_stride * rect.top() + rect.left();
-        libyuv::ARGBToI444(rgb_data + rgb_offset, rgb_stride,
-                           y_data + yuv_offset, y_stride,
-                           u_data + yuv_offset, uv_stride,
-                           v_data + yuv_offset, uv_stride,
-                           rect.width(), rect.height());
-      }
-      break;
-    case VPX_IMG_FMT_YV12:
-      for (webrtc::DesktopRegion::Iterator r(*updated_region); !r.IsAtEnd();
-           r.Advance()) {
-        const webrtc::DesktopRect& rect = r.rect();
-        int rgb_offset = rgb_stride * rect.top() +
-                         rect.left() * kBytesPerRgbPixel;
-        int y_offset = y_stride * rect.top() + rect.left();
-        int uv_offset = uv_stride * rect.top() / 2 + rect.left() / 2;
-        libyuv::ARGBToI420(rgb_data + rgb_offset, rgb_stride,
-                           y_data + y_offset, y_stride,
-                           u_data + uv_offset, uv_stride,
-                           v_data + uv_offset, uv_stride,
-                           rect.width(), rect.height());
+  std::vector<webrtc::DesktopRect> rects;
+  int num_pixels = 0;
+  for (webrtc::DesktopRegion::Iterator r(*updated_region); !r.IsAtEnd();
+       r.Advance()) {
+    rects.push_back(r.rect());
+    num_pixels += r.rect().width() * r.rect().height();
+  }
+
+  int num_threads = std::min(GetThreadCount(frame.size()),
+                             num_pixels / kPixelsPerConversionThread);
+  if (num_threads <= 1) {
+    ConvertRectsToYuv(&frame, image_.get(), &rects);
+    return;
+  }
+
+  // Split the rectangles into bands of whole macroblock rows, giving each
+  // thread a similar number of pixels. Bands of one rectangle don't share
+  // chroma rows, so the threads never write to the same memory.
+  std::vector<std::vector<webrtc::DesktopRect> > thread_rects(num_threads);
+  const int pixels_per_thread = (num_pixels + num_threads - 1) / num_threads;
+  size_t thread = 0;
+  int thread_pixels = 0;
+  for (size_t i = 0; i < rects.size(); ++i) {
+    const webrtc::DesktopRect& rect = rects[i];
+    int top = rect.top();
+    while (top < rect.bottom()) {
+      int rows = (pixels_per_thread - thread_pixels + rect.width() - 1) /
+                 rect.width();
+      rows = (rows + kMacroBlockSize - 1) / kMacroBlockSize * kMacroBlockSize;
+      int bottom = std::min(rect.bottom(), top + rows);
+      thread_rects[thread].push_back(webrtc::DesktopRect::MakeLTRB(
+          rect.left(), top, rect.right(), bottom));
+      thread_pixels += rect.width() * (bottom - top);
+      top = bottom;
+      if (thread_pixels >= pixels_per_thread &&
+          thread + 1 < thread_rects.size()) {
+        ++thread;
+        thread_pixels = 0;
       }
-      break;
-    default:
-      NOTREACHED();
-      break;
+    }
+  }
+
+  // Convert the first band on this thread while the worker pool handles the
+  // rest.
+  base::WaitableEvent done_event(false, false);
+  base::Closure done_callback = base::BarrierClosure(
+      num_threads - 1,
+      base::Bind(&base::WaitableEvent::Signal, base::Unretained(&done_event)));
+  for (int i = 1; i < num_threads; ++i) {
+    base::WorkerPool::PostTask(
+        FROM_HERE,
+        base::Bind(&ConvertRectsToYuvAndSignal, &frame, image_.get(),
+                   &thread_rects[i], done_callback),
+        false);
   }
+  ConvertRectsToYuv(&frame, image_.get(), &thread_rects[0]);
+  done_event.Wait();
 }
 
 void VideoEncoderVpx::PrepareActiveMap(
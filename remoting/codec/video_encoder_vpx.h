@@ -28,6 +28,10 @@ class VideoEncoderVpx : public VideoEncoder {
 
   ~VideoEncoderVpx() override;
 
+  // Estimated cost, in pixels, of converting and encoding an extra rectangle
+  // of the updated region. Passed to CoalesceRegion() before encoding.
+  static const int kCoalesceRectCost;
+
   // VideoEncoder interface.
   void SetLosslessEncode(bool want_lossless) override;
   void SetLosslessColor(bool want_lossless) override;
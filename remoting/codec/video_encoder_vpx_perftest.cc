@@ -5,24 +5,116 @@
 #include "remoting/codec/video_encoder_vpx.h"
 
 #include <limits>
+#include <list>
 #include <vector>
 
+#include "base/bind.h"
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
+#include "remoting/base/util.h"
 #include "remoting/codec/codec_test.h"
+#include "remoting/host/fake_desktop_capturer.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/webrtc/modules/desktop_capture/desktop_frame.h"
 #include "third_party/webrtc/modules/desktop_capture/desktop_geometry.h"
+#include "third_party/webrtc/modules/desktop_capture/desktop_region.h"
 
 using webrtc::DesktopSize;
 
 namespace remoting {
 
+namespace {
+
+// Number of small areas which change in every frame generated by
+// ScatteredChangeGenerator, and their size.
+const int kNumScatteredChanges = 64;
+const int kScatteredChangeSize = 8;
+
+// Generates 1920x1080 frames in which many small areas scattered across the
+// screen change every frame, like a desktop showing several blinking cursors
+// and updating counters.
+class ScatteredChangeGenerator {
+ public:
+  ScatteredChangeGenerator()
+      : screen_(new webrtc::BasicDesktopFrame(DesktopSize(1920, 1080))),
+        random_state_(1),
+        frame_count_(0) {
+    memset(screen_->data(), 0xff,
+           screen_->stride() * screen_->size().height());
+  }
+
+  scoped_ptr<webrtc::DesktopFrame> GenerateFrame(
+      webrtc::DesktopCapturer::Callback* callback) {
+    webrtc::DesktopRegion updated_region;
+    for (int i = 0; i < kNumScatteredChanges; ++i) {
+      int x = Random(screen_->size().width() - kScatteredChangeSize);
+      int y = Random(screen_->size().height() - kScatteredChangeSize);
+      uint8* row = screen_->data() + y * screen_->stride() +
+                   x * webrtc::DesktopFrame::kBytesPerPixel;
+      for (int line = 0; line < kScatteredChangeSize; ++line) {
+        memset(row, frame_count_ + i,
+               kScatteredChangeSize * webrtc::DesktopFrame::kBytesPerPixel);
+        row += screen_->stride();
+      }
+      updated_region.AddRect(webrtc::DesktopRect::MakeXYWH(
+          x, y, kScatteredChangeSize, kScatteredChangeSize));
+    }
+    frame_count_++;
+
+    scoped_ptr<webrtc::DesktopFrame> frame(
+        new webrtc::BasicDesktopFrame(screen_->size()));
+    frame->CopyPixelsFrom(*screen_, webrtc::DesktopVector(),
+                          webrtc::DesktopRect::MakeSize(screen_->size()));
+    frame->mutable_updated_region()->Swap(&updated_region);
+    return frame.Pass();
+  }
+
+ private:
+  // Returns a pseudo-random number in [0, range), the same sequence in each
+  // run.
+  int Random(int range) {
+    random_state_ = random_state_ * 1103515245 + 12345;
+    return (random_state_ >> 16) % range;
+  }
+
+  scoped_ptr<webrtc::DesktopFrame> screen_;
+  uint32 random_state_;
+  int frame_count_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScatteredChangeGenerator);
+};
+
+// Keeps the frames captured by a FakeDesktopCapturer.
+class FrameCollector : public webrtc::DesktopCapturer::Callback {
+ public:
+  FrameCollector() {}
+
+  // webrtc::DesktopCapturer::Callback interface.
+  webrtc::SharedMemory* CreateSharedMemory(size_t size) override {
+    return nullptr;
+  }
+  void OnCaptureCompleted(webrtc::DesktopFrame* frame) override {
+    frames_.push_back(frame);
+  }
+
+  ScopedVector<webrtc::DesktopFrame>& frames() { return frames_; }
+
+ private:
+  ScopedVector<webrtc::DesktopFrame> frames_;
+
+  DISALLOW_COPY_AND_ASSIGN(FrameCollector);
+};
+
+}  // namespace
+
 // Measure the performance of the VP8 encoder.
 TEST(VideoEncoderVpxTest, MeasureVp8Fps) {
   scoped_ptr<VideoEncoderVpx> encoder(VideoEncoderVpx::CreateForVP8());
 
   const DesktopSize kFrameSizes[] = {
-    DesktopSize(1280, 1024), DesktopSize(1920, 1200)
+    DesktopSize(1280, 1024), DesktopSize(1920, 1080), DesktopSize(1920, 1200),
+    DesktopSize(3840, 2160)
   };
 
   for (size_t i = 0; i < arraysize(kFrameSizes); ++i) {
@@ -36,7 +128,8 @@ TEST(VideoEncoderVpxTest, MeasureVp8Fps) {
 // Measure the performance of the VP9 encoder.
 TEST(VideoEncoderVpxTest, MeasureVp9Fps) {
   const DesktopSize kFrameSizes[] = {
-    DesktopSize(1280, 1024), DesktopSize(1920, 1200)
+    DesktopSize(1280, 1024), DesktopSize(1920, 1080), DesktopSize(1920, 1200),
+    DesktopSize(3840, 2160)
   };
 
   for (int lossless_mode = 0; lossless_mode < 4; ++lossless_mode) {
@@ -58,4 +151,42 @@ TEST(VideoEncoderVpxTest, MeasureVp9Fps) {
   }
 }
 
+// Measure the performance of the VP8 encoder on frames with many scattered
+// small changes, and how much region coalescing reduces their rectangles.
+TEST(VideoEncoderVpxTest, MeasureVp8FpsScatteredChanges) {
+  const int kNumFrames = 30;
+
+  ScatteredChangeGenerator generator;
+  FakeDesktopCapturer capturer;
+  capturer.set_frame_generator(
+      base::Bind(&ScatteredChangeGenerator::GenerateFrame,
+                 base::Unretained(&generator)));
+  FrameCollector collector;
+  capturer.Start(&collector);
+  for (int i = 0; i < kNumFrames; ++i)
+    capturer.Capture(webrtc::DesktopRegion());
+
+  int rects_before = 0;
+  int rects_after = 0;
+  std::list<webrtc::DesktopFrame*> frames;
+  for (size_t i = 0; i < collector.frames().size(); ++i) {
+    webrtc::DesktopFrame* frame = collector.frames()[i];
+    frames.push_back(frame);
+
+    webrtc::DesktopRegion region(frame->updated_region());
+    for (webrtc::DesktopRegion::Iterator r(region); !r.IsAtEnd(); r.Advance())
+      rects_before++;
+    CoalesceRegion(VideoEncoderVpx::kCoalesceRectCost, &region);
+    for (webrtc::DesktopRegion::Iterator r(region); !r.IsAtEnd(); r.Advance())
+      rects_after++;
+  }
+
+  scoped_ptr<VideoEncoderVpx> encoder(VideoEncoderVpx::CreateForVP8());
+  float fps = MeasureVideoEncoderFpsWithFrames(encoder.get(), frames);
+  LOG(ERROR) << "1920x1080 with " << kNumScatteredChanges
+             << " scattered changes: " << fps << "fps, "
+             << rects_before / kNumFrames << " rects per frame, "
+             << rects_after / kNumFrames << " after coalescing";
+}
+
 }  // namespace remoting
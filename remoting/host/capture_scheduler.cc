@@ -24,6 +24,10 @@ const int64 kDefaultMinimumIntervalMs = 33;
 // available while 1 means using 100% of all CPUs available.
 const double kRecordingCpuConsumption = 0.5;
 
+// Maximum number of frames that can be processed simultaneously. Two frames
+// let the next capture and encode overlap with sending the previous frame.
+const int kMaxPendingFrames = 2;
+
 }  // namespace
 
 namespace remoting {
@@ -34,7 +38,8 @@ CaptureScheduler::CaptureScheduler()
           base::TimeDelta::FromMilliseconds(kDefaultMinimumIntervalMs)),
       num_of_processors_(base::SysInfo::NumberOfProcessors()),
       capture_time_(kStatisticsWindow),
-      encode_time_(kStatisticsWindow) {
+      encode_time_(kStatisticsWindow),
+      send_time_(kStatisticsWindow) {
   DCHECK(num_of_processors_);
 }
 
@@ -54,6 +59,16 @@ base::TimeDelta CaptureScheduler::NextCaptureDelay() {
   return delay;
 }
 
+int CaptureScheduler::MaxPendingFrames() {
+  // When sending takes longer than capturing and encoding, the network is the
+  // bottleneck and a second frame would only wait in the socket writer's
+  // queue, adding its send time to the latency. Keep a single frame in flight
+  // then; the capturer accumulates changes until the next capture anyway.
+  if (send_time_.Average() > capture_time_.Average() + encode_time_.Average())
+    return 1;
+  return kMaxPendingFrames;
+}
+
 void CaptureScheduler::RecordCaptureTime(base::TimeDelta capture_time) {
   capture_time_.Record(capture_time.InMilliseconds());
 }
@@ -62,6 +77,10 @@ void CaptureScheduler::RecordEncodeTime(base::TimeDelta encode_time) {
   encode_time_.Record(encode_time.InMilliseconds());
 }
 
+void CaptureScheduler::RecordSendTime(base::TimeDelta send_time) {
+  send_time_.Record(send_time.InMilliseconds());
+}
+
 void CaptureScheduler::SetNumOfProcessorsForTest(int num_of_processors) {
   num_of_processors_ = num_of_processors;
 }
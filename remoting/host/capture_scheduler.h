@@ -4,7 +4,8 @@
 
 // This class chooses a capture interval so as to limit CPU usage to not exceed
 // a specified %age. It bases this on the CPU usage of recent capture and encode
-// operations, and on the number of available CPUs.
+// operations, and on the number of available CPUs. It also limits the number
+// of frames in flight based on how long recent frames took to be sent.
 
 #ifndef REMOTING_HOST_CAPTURE_SCHEDULER_H_
 #define REMOTING_HOST_CAPTURE_SCHEDULER_H_
@@ -23,10 +24,18 @@ class CaptureScheduler {
   // the next.
   base::TimeDelta NextCaptureDelay();
 
+  // Returns the maximum number of frames which may be captured, encoded or
+  // sent at the same time.
+  int MaxPendingFrames();
+
   // Records time spent on capturing and encoding.
   void RecordCaptureTime(base::TimeDelta capture_time);
   void RecordEncodeTime(base::TimeDelta encode_time);
 
+  // Records time spent sending an encoded frame, from when it was passed to
+  // the network until the write completed.
+  void RecordSendTime(base::TimeDelta send_time);
+
   // Sets minimum interval between frames.
   void set_minimum_interval(base::TimeDelta minimum_interval) {
     minimum_interval_ = minimum_interval;
@@ -40,6 +49,7 @@ class CaptureScheduler {
   int num_of_processors_;
   RunningAverage capture_time_;
   RunningAverage encode_time_;
+  RunningAverage send_time_;
 
   DISALLOW_COPY_AND_ASSIGN(CaptureScheduler);
 };
@@ -84,4 +84,42 @@ TEST(CaptureSchedulerTest, RollingAverageDifferentTimes) {
   }
 }
 
+// Returns how long it takes to write a frame of |frame_bytes| to a link of
+// |bandwidth_kbps| with a round trip time of |rtt_ms|.
+static base::TimeDelta SimulatedSendTime(int frame_bytes,
+                                         int bandwidth_kbps,
+                                         int rtt_ms) {
+  return base::TimeDelta::FromMilliseconds(
+      frame_bytes * 8 / bandwidth_kbps + rtt_ms / 2);
+}
+
+TEST(CaptureSchedulerTest, PendingFramesLimitedBySlowNetwork) {
+  const int kFrameBytes = 50 * 1024;
+  const int kTimingWindow = 3;
+
+  CaptureScheduler scheduler;
+  scheduler.SetNumOfProcessorsForTest(2);
+  EXPECT_EQ(2, scheduler.MaxPendingFrames());
+
+  // On a fast LAN, sending is quicker than capturing and encoding, so the
+  // next frame is captured while the previous one is being sent.
+  for (int i = 0; i < kTimingWindow; ++i) {
+    scheduler.RecordCaptureTime(base::TimeDelta::FromMilliseconds(10));
+    scheduler.RecordEncodeTime(base::TimeDelta::FromMilliseconds(20));
+    scheduler.RecordSendTime(SimulatedSendTime(kFrameBytes, 100000, 1));
+  }
+  EXPECT_EQ(2, scheduler.MaxPendingFrames());
+
+  // On a 1Mbps link with 100ms RTT, a second frame would only queue up
+  // behind the first one.
+  for (int i = 0; i < kTimingWindow; ++i)
+    scheduler.RecordSendTime(SimulatedSendTime(kFrameBytes, 1000, 100));
+  EXPECT_EQ(1, scheduler.MaxPendingFrames());
+
+  // Pipelining resumes once the network recovers.
+  for (int i = 0; i < kTimingWindow; ++i)
+    scheduler.RecordSendTime(SimulatedSendTime(kFrameBytes, 100000, 1));
+  EXPECT_EQ(2, scheduler.MaxPendingFrames());
+}
+
 }  // namespace remoting
@@ -26,10 +26,6 @@
 
 namespace remoting {
 
-// Maximum number of frames that can be processed simultaneously.
-// TODO(hclam): Move this value to CaptureScheduler.
-static const int kMaxPendingFrames = 2;
-
 // Interval between empty keep-alive frames. These frames are sent only when the
 // stream is paused or inactive for some other reason (e.g. when blocked on
 // capturer). To prevent PseudoTCP from resetting congestion window this value
@@ -274,10 +270,11 @@ void VideoScheduler::CaptureNextFrame() {
   if (!capturer_ || is_paused_)
     return;
 
-  // Make sure we have at most two outstanding recordings. We can simply return
-  // if we can't make a capture now, the next capture will be started by the
-  // end of an encode operation.
-  if (pending_frames_ >= kMaxPendingFrames || capture_pending_) {
+  // Make sure we have at most as many outstanding recordings as the scheduler
+  // allows. We can simply return if we can't make a capture now, the next
+  // capture will be started by the end of an encode operation. Changes on
+  // screen meanwhile are merged into that capture rather than queued.
+  if (pending_frames_ >= scheduler_.MaxPendingFrames() || capture_pending_) {
     did_skip_frame_ = true;
     return;
   }
@@ -286,7 +283,6 @@ void VideoScheduler::CaptureNextFrame() {
 
   // At this point we are going to perform one capture so save the current time.
   pending_frames_++;
-  DCHECK_LE(pending_frames_, kMaxPendingFrames);
 
   // Before doing a capture schedule for the next one.
   ScheduleNextCapture();
@@ -300,9 +296,11 @@ void VideoScheduler::CaptureNextFrame() {
   capturer_->Capture(webrtc::DesktopRegion());
 }
 
-void VideoScheduler::FrameCaptureCompleted() {
+void VideoScheduler::FrameCaptureCompleted(base::TimeDelta send_time) {
   DCHECK(capture_task_runner_->BelongsToCurrentThread());
 
+  scheduler_.RecordSendTime(send_time);
+
   // Decrement the pending capture count.
   pending_frames_--;
   DCHECK_GE(pending_frames_, 0);
@@ -322,10 +320,11 @@ void VideoScheduler::SendVideoPacket(scoped_ptr<VideoPacket> packet) {
     return;
 
   video_stub_->ProcessVideoPacket(
-      packet.Pass(), base::Bind(&VideoScheduler::OnVideoPacketSent, this));
+      packet.Pass(), base::Bind(&VideoScheduler::OnVideoPacketSent, this,
+                                base::TimeTicks::Now()));
 }
 
-void VideoScheduler::OnVideoPacketSent() {
+void VideoScheduler::OnVideoPacketSent(base::TimeTicks send_start_time) {
   DCHECK(network_task_runner_->BelongsToCurrentThread());
 
   if (!video_stub_)
@@ -334,7 +333,8 @@ void VideoScheduler::OnVideoPacketSent() {
   keep_alive_timer_->Reset();
 
   capture_task_runner_->PostTask(
-      FROM_HERE, base::Bind(&VideoScheduler::FrameCaptureCompleted, this));
+      FROM_HERE, base::Bind(&VideoScheduler::FrameCaptureCompleted, this,
+                            base::TimeTicks::Now() - send_start_time));
 }
 
 void VideoScheduler::SendKeepAlivePacket() {
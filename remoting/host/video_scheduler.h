@@ -142,7 +142,8 @@ class VideoScheduler : public base::RefCountedThreadSafe<VideoScheduler>,
   void CaptureNextFrame();
 
   // Called when a frame capture has been encoded & sent to the client.
-  void FrameCaptureCompleted();
+  // |send_time| is how long the network took to send the frame.
+  void FrameCaptureCompleted(base::TimeDelta send_time);
 
   // Network thread -----------------------------------------------------------
 
@@ -150,8 +151,9 @@ class VideoScheduler : public base::RefCountedThreadSafe<VideoScheduler>,
   void SendVideoPacket(scoped_ptr<VideoPacket> packet);
 
   // Callback passed to |video_stub_| for the last packet in each frame, to
-  // rate-limit frame captures to network throughput.
-  void OnVideoPacketSent();
+  // rate-limit frame captures to network throughput. |send_start_time| is
+  // when the packet was passed to |video_stub_|.
+  void OnVideoPacketSent(base::TimeTicks send_start_time);
 
   // Called by |keep_alive_timer_|.
   void SendKeepAlivePacket();
@@ -199,8 +201,8 @@ class VideoScheduler : public base::RefCountedThreadSafe<VideoScheduler>,
   scoped_ptr<base::DelayTimer<VideoScheduler> > keep_alive_timer_;
 
   // The number of frames being processed, i.e. frames that we are currently
-  // capturing, encoding or sending. The value is capped at 2 to minimize
-  // latency.
+  // capturing, encoding or sending. The value is capped by
+  // CaptureScheduler::MaxPendingFrames() to minimize latency.
   int pending_frames_;
 
   // Set when the capturer is capturing a frame.
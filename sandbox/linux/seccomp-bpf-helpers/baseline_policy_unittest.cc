@@ -21,10 +21,13 @@
 #include <time.h>
 #include <unistd.h>
 
+#include <iostream>
+
 #include "base/files/scoped_file.h"
 #include "base/macros.h"
 #include "base/posix/eintr_wrapper.h"
 #include "base/threading/thread.h"
+#include "base/time/time.h"
 #include "build/build_config.h"
 #include "sandbox/linux/seccomp-bpf-helpers/sigsys_handlers.h"
 #include "sandbox/linux/seccomp-bpf/bpf_tests.h"
@@ -63,6 +66,41 @@ void TestPipeOrSocketPair(base::ScopedFD read_end, base::ScopedFD write_end) {
   BPF_ASSERT_EQ(0, memcmp(kTestString, read_buf, kTestTransferSize));
 }
 
+// Returns the mean time, in nanoseconds, that an allowed system call and a
+// system call failed by the filter take.
+void GetSyscallCosts(double* allowed_ns, double* denied_ns) {
+  const int kIterations = 100000;
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kIterations; ++i)
+    syscall(__NR_getppid);
+  *allowed_ns =
+      (base::TimeTicks::Now() - start).InMillisecondsF() * 1e6 / kIterations;
+
+  // fchmod() on a bad descriptor fails in the kernel without a filter, and
+  // with EPERM in the filter under the baseline policy.
+  start = base::TimeTicks::Now();
+  for (int i = 0; i < kIterations; ++i)
+    fchmod(-1, 07777);
+  *denied_ns =
+      (base::TimeTicks::Now() - start).InMillisecondsF() * 1e6 / kIterations;
+}
+
+// Not a correctness test: reports what the baseline policy's filter costs on
+// every system call, for comparison with SyscallCostWithFilter.
+TEST(BaselinePolicy, SyscallCostWithoutFilter) {
+  double allowed_ns, denied_ns;
+  GetSyscallCosts(&allowed_ns, &denied_ns);
+  std::cout << "Without a filter, ns: " << allowed_ns << " getppid(), "
+            << denied_ns << " fchmod()" << std::endl;
+}
+
+BPF_TEST_C(BaselinePolicy, SyscallCostWithFilter, BaselinePolicy) {
+  double allowed_ns, denied_ns;
+  GetSyscallCosts(&allowed_ns, &denied_ns);
+  std::cout << "Baseline policy filter, ns: " << allowed_ns << " getppid(), "
+            << denied_ns << " fchmod()" << std::endl;
+}
+
 // Test that a few easy-to-test system calls are allowed.
 BPF_TEST_C(BaselinePolicy, BaselinePolicyBasicAllowed, BaselinePolicy) {
   BPF_ASSERT_EQ(0, sched_yield());
@@ -14,6 +14,7 @@
 #include <unistd.h>
 
 #include <algorithm>
+#include <iostream>
 #include <string>
 #include <vector>
 
@@ -25,6 +26,7 @@
 #include "base/memory/scoped_ptr.h"
 #include "base/posix/eintr_wrapper.h"
 #include "base/posix/unix_domain_socket_linux.h"
+#include "base/time/time.h"
 #include "sandbox/linux/syscall_broker/broker_client.h"
 #include "sandbox/linux/tests/scoped_temporary_file.h"
 #include "sandbox/linux/tests/test_utils.h"
@@ -652,6 +654,52 @@ TEST(BrokerProcess, CreateFile) {
   }
 }
 
+// Not a correctness test: reports what a round trip to the broker costs, next
+// to the same open() and access() made directly.
+TEST(BrokerProcess, RoundTripCost) {
+  const char kFileCpuInfo[] = "/proc/cpuinfo";
+  const int kIterations = 1000;
+  std::vector<BrokerFilePermission> permissions;
+  permissions.push_back(BrokerFilePermission::ReadOnly(kFileCpuInfo));
+  BrokerProcess open_broker(EPERM, permissions);
+  ASSERT_TRUE(open_broker.Init(base::Bind(&NoOpCallback)));
+
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kIterations; ++i) {
+    base::ScopedFD fd(open(kFileCpuInfo, O_RDONLY));
+    ASSERT_TRUE(fd.is_valid());
+  }
+  const base::TimeDelta direct_open = base::TimeTicks::Now() - start;
+
+  start = base::TimeTicks::Now();
+  for (int i = 0; i < kIterations; ++i) {
+    base::ScopedFD fd(open_broker.Open(kFileCpuInfo, O_RDONLY));
+    ASSERT_TRUE(fd.is_valid());
+  }
+  const base::TimeDelta broker_open = base::TimeTicks::Now() - start;
+
+  start = base::TimeTicks::Now();
+  for (int i = 0; i < kIterations; ++i)
+    ASSERT_EQ(0, access(kFileCpuInfo, R_OK));
+  const base::TimeDelta direct_access = base::TimeTicks::Now() - start;
+
+  start = base::TimeTicks::Now();
+  for (int i = 0; i < kIterations; ++i)
+    ASSERT_EQ(0, open_broker.Access(kFileCpuInfo, R_OK));
+  const base::TimeDelta broker_access = base::TimeTicks::Now() - start;
+
+  std::cout << "open(), us: "
+            << direct_open.InMillisecondsF() * 1000 / kIterations
+            << " direct, "
+            << broker_open.InMillisecondsF() * 1000 / kIterations
+            << " brokered\n";
+  std::cout << "access(), us: "
+            << direct_access.InMillisecondsF() * 1000 / kIterations
+            << " direct, "
+            << broker_access.InMillisecondsF() * 1000 / kIterations
+            << " brokered\n";
+}
+
 }  // namespace syscall_broker
 
 }  // namespace sandbox
@@ -39,24 +39,39 @@ inline void NinjaEscapeChar(char ch, DestString* dest) {
   dest->push_back(ch);
 }
 
+// Most paths and flags contain no special characters at all, so the escaping
+// functions below copy runs of literal characters in one append rather than
+// one character at a time.
 template<typename DestString>
 void EscapeStringToString_Ninja(const base::StringPiece& str,
                                 const EscapeOptions& options,
                                 DestString* dest,
                                 bool* needed_quoting) {
-  for (size_t i = 0; i < str.size(); i++)
-    NinjaEscapeChar(str[i], dest);
+  size_t run_begin = 0;
+  for (size_t i = 0; i < str.size(); i++) {
+    if (str[i] == '$' || str[i] == ' ' || str[i] == ':') {
+      // Flush the literal run, then start the next one at the escaped char.
+      dest->append(str.data() + run_begin, i - run_begin);
+      dest->push_back('$');
+      run_begin = i;
+    }
+  }
+  dest->append(str.data() + run_begin, str.size() - run_begin);
 }
 
 template<typename DestString>
 void EscapeStringToString_NinjaPreformatted(const base::StringPiece& str,
                                             DestString* dest) {
   // Only Ninja-escape $.
+  size_t run_begin = 0;
   for (size_t i = 0; i < str.size(); i++) {
-    if (str[i] == '$')
+    if (str[i] == '$') {
+      dest->append(str.data() + run_begin, i - run_begin);
       dest->push_back('$');
-    dest->push_back(str[i]);
+      run_begin = i;
+    }
   }
+  dest->append(str.data() + run_begin, str.size() - run_begin);
 }
 
 // Escape for CommandLineToArgvW and additionally escape Ninja characters.
@@ -118,7 +133,16 @@ void EscapeStringToString_PosixNinjaFork(const base::StringPiece& str,
                                          const EscapeOptions& options,
                                          DestString* dest,
                                          bool* needed_quoting) {
+  size_t run_begin = 0;
   for (size_t i = 0; i < str.size(); i++) {
+    if (str[i] != ':' && static_cast<unsigned>(str[i]) < 0x80 &&
+        kShellValid[static_cast<int>(str[i])]) {
+      // A literal, it will be written as part of the current run.
+      continue;
+    }
+    dest->append(str.data() + run_begin, i - run_begin);
+    run_begin = i + 1;
+
     if (str[i] == '$' || str[i] == ' ') {
       // Space and $ are special to both Ninja and the shell. '$' escape for
       // Ninja, then backslash-escape for the shell.
@@ -130,16 +154,13 @@ void EscapeStringToString_PosixNinjaFork(const base::StringPiece& str,
       // the shell.
       dest->push_back('$');
       dest->push_back(':');
-    } else if (static_cast<unsigned>(str[i]) >= 0x80 ||
-               !kShellValid[static_cast<int>(str[i])]) {
+    } else {
       // All other invalid shell chars get backslash-escaped.
       dest->push_back('\\');
       dest->push_back(str[i]);
-    } else {
-      // Everything else is a literal.
-      dest->push_back(str[i]);
     }
   }
+  dest->append(str.data() + run_begin, str.size() - run_begin);
 }
 
 template<typename DestString>
@@ -199,6 +220,11 @@ std::string EscapeString(const base::StringPiece& str,
 void EscapeStringToStream(std::ostream& out,
                           const base::StringPiece& str,
                           const EscapeOptions& options) {
+  if (options.mode == ESCAPE_NONE) {
+    out.write(str.data(), str.size());
+    return;
+  }
+
   base::StackString<256> escaped;
   EscapeStringToString(str, options, &escaped.container(), nullptr);
   if (!escaped->empty())
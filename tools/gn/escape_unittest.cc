@@ -10,6 +10,10 @@ TEST(Escape, Ninja) {
   opts.mode = ESCAPE_NINJA;
   std::string result = EscapeString("asdf: \"$\\bar", opts, nullptr);
   EXPECT_EQ("asdf$:$ \"$$\\bar", result);
+
+  // Leading, trailing and adjacent special characters.
+  EXPECT_EQ("$$$:foo$ $ bar$:", EscapeString("$:foo  bar:", opts, nullptr));
+  EXPECT_EQ("", EscapeString("", opts, nullptr));
 }
 
 TEST(Escape, WindowsCommand) {
@@ -49,6 +53,9 @@ TEST(Escape, PosixCommand) {
 
   // Some more generic shell chars.
   EXPECT_EQ("a_\\;\\<\\*b", EscapeString("a_;<*b", opts, nullptr));
+
+  // Special characters at the ends of the string and next to each other.
+  EXPECT_EQ("\\$ a\\;\\;b$:", EscapeString(" a;;b:", opts, nullptr));
 }
 
 TEST(Escape, NinjaPreformatted) {
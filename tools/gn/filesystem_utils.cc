@@ -11,6 +11,7 @@
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
 #include "build/build_config.h"
+#include "tools/gn/err.h"
 #include "tools/gn/location.h"
 #include "tools/gn/settings.h"
 #include "tools/gn/source_dir.h"
@@ -676,6 +677,31 @@ std::string GetOutputSubdirName(const Label& toolchain_label, bool is_default) {
   return toolchain_label.name() + "/";
 }
 
+bool WriteFileIfChanged(const base::FilePath& file_path,
+                        const std::string& data,
+                        Err* err) {
+  // Only bother reading the old file if it's the right size.
+  int64 file_size;
+  if (base::GetFileSize(file_path, &file_size) &&
+      static_cast<size_t>(file_size) == data.size()) {
+    std::string existing_data;
+    if (base::ReadFileToString(file_path, &existing_data) &&
+        existing_data == data)
+      return true;
+  }
+
+  base::CreateDirectory(file_path.DirName());
+  int size = static_cast<int>(data.size());
+  if (base::WriteFile(file_path, data.c_str(), size) != size) {
+    if (err) {
+      *err = Err(Location(), "Unable to write file.",
+                 "I was writing \"" + FilePathToUTF8(file_path) + "\".");
+    }
+    return false;
+  }
+  return true;
+}
+
 SourceDir GetToolchainOutputDir(const Settings* settings) {
   return settings->toolchain_output_subdir().AsSourceDir(
       settings->build_settings());
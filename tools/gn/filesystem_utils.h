@@ -159,6 +159,14 @@ SourceDir SourceDirForCurrentDirectory(const base::FilePath& source_root);
 // go in the root build directory. Otherwise, the result will end in a slash.
 std::string GetOutputSubdirName(const Label& toolchain_label, bool is_default);
 
+// Writes |data| to |file_path|, creating the containing directory if needed,
+// unless the file already has exactly these contents. Leaving unchanged files
+// alone keeps regeneration cheap and avoids bumping timestamps that ninja
+// would otherwise see. On failure, returns false and sets |err| if non-null.
+bool WriteFileIfChanged(const base::FilePath& file_path,
+                        const std::string& data,
+                        Err* err);
+
 // -----------------------------------------------------------------------------
 
 // These functions return the various flavors of output and gen directories.
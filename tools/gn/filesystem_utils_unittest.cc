@@ -3,6 +3,8 @@
 // found in the LICENSE file.
 
 #include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
 #include "build/build_config.h"
@@ -556,6 +558,36 @@ TEST(FilesystemUtils, GetTargetDirs) {
   EXPECT_EQ("gen/foo/bar/", GetTargetGenDirAsOutputFile(&a).value());
 }
 
+TEST(FilesystemUtils, WriteFileIfChanged) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+
+  // Writing creates missing directories.
+  base::FilePath file_path =
+      temp_dir.path().AppendASCII("foo").AppendASCII("bar.ninja");
+  EXPECT_TRUE(WriteFileIfChanged(file_path, "contents", NULL));
+  std::string read_back;
+  ASSERT_TRUE(base::ReadFileToString(file_path, &read_back));
+  EXPECT_EQ("contents", read_back);
+
+  // Rewriting the same contents leaves the file's timestamp alone.
+  base::Time old_time = base::Time::Now() - base::TimeDelta::FromDays(1);
+  ASSERT_TRUE(base::TouchFile(file_path, old_time, old_time));
+  base::File::Info file_info;
+  ASSERT_TRUE(base::GetFileInfo(file_path, &file_info));
+  base::Time unchanged_time = file_info.last_modified;
+  EXPECT_TRUE(WriteFileIfChanged(file_path, "contents", NULL));
+  ASSERT_TRUE(base::GetFileInfo(file_path, &file_info));
+  EXPECT_EQ(unchanged_time, file_info.last_modified);
+
+  // New contents of the same size are still written.
+  EXPECT_TRUE(WriteFileIfChanged(file_path, "CONTENTS", NULL));
+  ASSERT_TRUE(base::ReadFileToString(file_path, &read_back));
+  EXPECT_EQ("CONTENTS", read_back);
+  ASSERT_TRUE(base::GetFileInfo(file_path, &file_info));
+  EXPECT_NE(unchanged_time, file_info.last_modified);
+}
+
 // Tests handling of output dirs when build dir is the same as the root.
 TEST(FilesystemUtils, GetDirForEmptyBuildDir) {
   BuildSettings build_settings;
@@ -170,23 +170,24 @@ void HeaderChecker::RunCheckOverFiles(const FileMap& files, bool force_check) {
         continue;
     }
 
-    for (const auto& vect_i : file.second) {
-      pool->PostWorkerTaskWithShutdownBehavior(
-          FROM_HERE,
-          base::Bind(&HeaderChecker::DoWork, this, vect_i.target, file.first),
-          base::SequencedWorkerPool::BLOCK_SHUTDOWN);
-    }
+    // |files| outlives the pool, so the tasks can refer to its entries.
+    pool->PostWorkerTaskWithShutdownBehavior(
+        FROM_HERE,
+        base::Bind(&HeaderChecker::DoWork, this, &file.second, file.first),
+        base::SequencedWorkerPool::BLOCK_SHUTDOWN);
   }
 
   // After this call we're single-threaded again.
   pool->Shutdown();
 }
 
-void HeaderChecker::DoWork(const Target* target, const SourceFile& file) {
-  Err err;
-  if (!CheckFile(target, file, &err)) {
+void HeaderChecker::DoWork(const TargetVector* targets,
+                           const SourceFile& file) {
+  std::vector<Err> errors;
+  CheckFile(*targets, file, &errors);
+  if (!errors.empty()) {
     base::AutoLock lock(lock_);
-    errors_.push_back(err);
+    errors_.insert(errors_.end(), errors.begin(), errors.end());
   }
 }
 
@@ -256,9 +257,9 @@ SourceFile HeaderChecker::SourceFileForInclude(
   return SourceFile(str);
 }
 
-bool HeaderChecker::CheckFile(const Target* from_target,
+void HeaderChecker::CheckFile(const TargetVector& from_targets,
                               const SourceFile& file,
-                              Err* err) const {
+                              std::vector<Err>* errors) const {
   ScopedTrace trace(TraceItem::TRACE_CHECK_HEADER, file.value());
 
   // Sometimes you have generated source files included as sources in another
@@ -266,31 +267,44 @@ bool HeaderChecker::CheckFile(const Target* from_target,
   // files to be somewhere in the output tree, we can just check the name to
   // see if they should be skipped.
   if (IsFileInOuputDir(file))
-    return true;
+    return;
 
   base::FilePath path = build_settings_->GetFullPath(file);
   std::string contents;
   if (!base::ReadFileToString(path, &contents)) {
-    *err = Err(from_target->defined_from(), "Source file not found.",
-        "The target:\n  " + from_target->label().GetUserVisibleName(false) +
-        "\nhas a source file:\n  " + file.value() +
-        "\nwhich was not found.");
-    return false;
+    for (const auto& from : from_targets) {
+      const Target* from_target = from.target;
+      errors->push_back(Err(from_target->defined_from(),
+          "Source file not found.",
+          "The target:\n  " + from_target->label().GetUserVisibleName(false) +
+          "\nhas a source file:\n  " + file.value() +
+          "\nwhich was not found."));
+    }
+    return;
   }
 
   InputFile input_file(file);
   input_file.SetContents(contents);
 
+  // The includes don't depend on the target, so only scan the file once.
+  std::vector<std::pair<SourceFile, LocationRange> > includes;
   CIncludeIterator iter(&input_file);
   base::StringPiece current_include;
   LocationRange range;
-  while (iter.GetNextIncludeString(&current_include, &range)) {
-    SourceFile include = SourceFileForInclude(current_include);
-    if (!CheckInclude(from_target, input_file, include, range, err))
-      return false;
+  while (iter.GetNextIncludeString(&current_include, &range))
+    includes.push_back(std::make_pair(SourceFileForInclude(current_include),
+                                      range));
+
+  for (const auto& from : from_targets) {
+    for (const auto& include : includes) {
+      Err err;
+      if (!CheckInclude(from.target, input_file, include.first, include.second,
+                        &err)) {
+        errors->push_back(err);
+        break;
+      }
+    }
   }
-
-  return true;
 }
 
 // If the file exists:
@@ -336,6 +350,16 @@ bool HeaderChecker::CheckInclude(const Target* from_target,
     if (to_target == from_target)
       return true;
 
+    std::pair<const Target*, const Target*> dependency(to_target, from_target);
+    if (targets[i].is_public) {
+      base::AutoLock lock(permitted_dependencies_lock_);
+      if (permitted_dependencies_.count(dependency)) {
+        found_dependency = true;
+        last_error = Err();
+        break;
+      }
+    }
+
     bool is_permitted_chain = false;
     if (IsDependencyOf(to_target, from_target, &chain, &is_permitted_chain)) {
       DCHECK(chain.size() >= 2);
@@ -346,6 +370,8 @@ bool HeaderChecker::CheckInclude(const Target* from_target,
 
       if (targets[i].is_public && is_permitted_chain) {
         // This one is OK, we're done.
+        base::AutoLock lock(permitted_dependencies_lock_);
+        permitted_dependencies_.insert(dependency);
         last_error = Err();
         break;
       }
@@ -7,6 +7,7 @@
 
 #include <map>
 #include <set>
+#include <utility>
 #include <vector>
 
 #include "base/basictypes.h"
@@ -94,7 +95,7 @@ class HeaderChecker : public base::RefCountedThreadSafe<HeaderChecker> {
   // will be populate on failure.
   void RunCheckOverFiles(const FileMap& flies, bool force_check);
 
-  void DoWork(const Target* target, const SourceFile& file);
+  void DoWork(const TargetVector* targets, const SourceFile& file);
 
   // Adds the sources and public files from the given target to the given map.
   static void AddTargetToFileMap(const Target* target, FileMap* dest);
@@ -105,11 +106,12 @@ class HeaderChecker : public base::RefCountedThreadSafe<HeaderChecker> {
   // Resolves the contents of an include to a SourceFile.
   SourceFile SourceFileForInclude(const base::StringPiece& input) const;
 
-  // from_target is the target the file was defined from. It will be used in
-  // error messages.
-  bool CheckFile(const Target* from_target,
+  // Reads the given file once and checks its includes against each of the
+  // targets it was defined from, appending at most one error per target to
+  // |errors|. The targets will be used in error messages.
+  void CheckFile(const TargetVector& from_targets,
                  const SourceFile& file,
-                 Err* err) const;
+                 std::vector<Err>* errors) const;
 
   // Checks that the given file in the given target can include the given
   // include file. If disallowed, returns false and sets the error. The
@@ -169,6 +171,14 @@ class HeaderChecker : public base::RefCountedThreadSafe<HeaderChecker> {
 
   std::vector<Err> errors_;
 
+  // Pairs of (to_target, from_target) for which a permitted dependency chain
+  // has been found, so public headers of to_target can be included from
+  // from_target without searching the dependency graph again. Most includes
+  // in a target resolve to the same handful of dependencies.
+  mutable base::Lock permitted_dependencies_lock_;
+  mutable std::set<std::pair<const Target*, const Target*> >
+      permitted_dependencies_;
+
   DISALLOW_COPY_AND_ASSIGN(HeaderChecker);
 };
 
@@ -183,6 +183,14 @@ TEST_F(HeaderCheckerTest, CheckInclude) {
   EXPECT_FALSE(checker->CheckInclude(&a_, input_file, c_private, range, &err));
   EXPECT_TRUE(err.has_error());
 
+  // The A -> C dependency is now known to be permitted, but that must not let
+  // A include C's private header either.
+  err = Err();
+  EXPECT_TRUE(checker->CheckInclude(&a_, input_file, c_public, range, &err));
+  EXPECT_FALSE(err.has_error());
+  EXPECT_FALSE(checker->CheckInclude(&a_, input_file, c_private, range, &err));
+  EXPECT_TRUE(err.has_error());
+
   // A can depend on a random file unknown to the build.
   err = Err();
   EXPECT_TRUE(checker->CheckInclude(&a_, input_file, SourceFile("//random.h"),
@@ -50,8 +50,6 @@ void NinjaTargetWriter::RunAndWriteFile(const Target* target) {
   if (g_scheduler->verbose_logging())
     g_scheduler->Log("Writing", FilePathToUTF8(ninja_file));
 
-  base::CreateDirectory(ninja_file.DirName());
-
   // It's rediculously faster to write to a string and then write that to
   // disk in one operation than to use an fstream here.
   std::stringstream file;
@@ -77,9 +75,7 @@ void NinjaTargetWriter::RunAndWriteFile(const Target* target) {
     CHECK(0);
   }
 
-  std::string contents = file.str();
-  base::WriteFile(ninja_file, contents.c_str(),
-                  static_cast<int>(contents.size()));
+  WriteFileIfChanged(ninja_file, file.str(), NULL);
 }
 
 void NinjaTargetWriter::WriteSharedVars(const SubstitutionBits& bits) {